@@ -0,0 +1,407 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// FBC benchmark and WDRC characterization (simulation only) for fixed-point C code
+// Scores FBC.Coeffs against the simulated feedback path while the simulation runs: misalignment,
+// time to converge after each feedback path change, and added stable gain.
+// Characterizes WDRC on its own (I/O curves, attack and release times) by driving it with channel levels.
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include "Common.h"
+#include <time.h>
+
+#define     BENCH_POW_FLOOR     1.0e-30     // Keep log10() finite when a bin has no feedback or no error
+#define     BENCH_DB_PER_LOG2   6.020599913279624   // 20*log10(2)
+
+
+static double BENCH_Db10(double Num, double Den)
+{
+    Num = (Num < BENCH_POW_FLOOR) ? BENCH_POW_FLOOR : Num;
+    Den = (Den < BENCH_POW_FLOOR) ? BENCH_POW_FLOOR : Den;
+    return 10.0*log10(Num/Den);
+}
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Functions
+
+// Call from SIM_Init(), after the feedback FIRs are loaded and after FBC_Init()
+//
+// Both the mic and the reverse analysis see SYS.OutBuf one block late, and the reverse input is delayed by
+// BulkDelay on top of that, so relative to the reverse analysis FBC is modelling
+//      W(k) = MicGain * sum_m h[m] e^(-jw(m - BulkDelay)),     w = 2*pi*k/WOLA_N
+// at the bin centres. The analysis is referenced to absolute time (circular shift in WOLA_Analyze), so a
+// bin-centre tone is constant from frame to frame and the taps of FBC.Coeffs add with no delay phase:
+//      F(k) = FBC_FILT_SCALE * sum_t C_t(k)
+// The tap spacing only shapes the response between bin centres, which is not scored.
+void BENCH_Init()
+{
+int24_t bin, m;
+double w, Ph;
+double MicGain;
+const double* Fir[BENCH_NUM_PATHS] = { SIM.FB_FIR1, SIM.FB_FIR2 };
+int24_t p;
+
+    if (!BENCH.Enable)
+        return;
+
+    if (SIM.FB_NumEvents > 0)
+    {
+        printf("\nWARNING: FBC benchmark scores one FIR1 to FIR2 transition, not a FB scenario; benchmark is off\n\n");
+        BENCH.Enable = false;
+        return;
+    }
+    if (!FBC_Params.Profile.Enable || (SIM.TransitionStart == (uint32_t)(-1)))
+    {
+        printf("\nWARNING: FBC benchmark needs FBC enabled and a feedback sim file (-f); benchmark is off\n\n");
+        BENCH.Enable = false;
+        return;
+    }
+
+    MicGain = pow(2.0, SYS.MicCalGainLog2);
+
+    for (bin = 0; bin < WOLA_NUM_BINS; bin++)
+    {
+        w = 2.0*M_PI*(double)bin/(double)WOLA_N;
+
+        for (p = 0; p < BENCH_NUM_PATHS; p++)
+        {
+            BENCH.TrueR[p][bin] = 0.0;
+            BENCH.TrueI[p][bin] = 0.0;
+            for (m = 0; m < SIM.FB_Taps; m++)
+            {
+                Ph = -w*(double)(m - FBC_Params.Persist.BulkDelay);
+                BENCH.TrueR[p][bin] += MicGain*Fir[p][m]*cos(Ph);
+                BENCH.TrueI[p][bin] += MicGain*Fir[p][m]*sin(Ph);
+            }
+        }
+    }
+
+    BENCH.Path = 0;
+    BENCH.PathsDone = 0;
+    BENCH.PathStart = 0;
+    BENCH.BelowSince = BENCH_NOT_CONVERGED;
+    BENCH.NumBlocks = 0;
+    BENCH.Cur.MinMisalignDb = BENCH_Db10(1.0, BENCH_POW_FLOOR);
+}
+
+
+static void BENCH_LatchPath()
+{
+strBenchPath* Res = &BENCH.Result[BENCH.PathsDone];
+
+    *Res = BENCH.Cur;
+    Res->ConvSample = (BENCH.BelowSince == BENCH_NOT_CONVERGED) ? BENCH_NOT_CONVERGED : (BENCH.BelowSince - BENCH.PathStart);
+    BENCH.PathsDone++;
+}
+
+
+// Call once per block, after the firmware has run
+void BENCH_Update()
+{
+int24_t bin, t;
+int24_t Path;
+double S1;
+double Tr, Ti, Fr, Fi, Dr, Di;
+double ErrPow, TruePow;
+double SumErr = 0.0, SumTrue = 0.0;
+double MaxErr = 0.0, MaxTrue = 0.0;
+
+    if (!BENCH.Enable)
+        return;
+
+    // Path change: score what FBC reached on the old path, then time convergence from the transition start
+    Path = (SIM.CurSample > SIM.TransitionStart) ? 1 : 0;
+    if (Path != BENCH.Path)
+    {
+        BENCH_LatchPath();
+        BENCH.Path = Path;
+        BENCH.PathStart = SIM.TransitionStart;
+        BENCH.BelowSince = BENCH_NOT_CONVERGED;
+        BENCH.Cur.MinMisalignDb = BENCH_Db10(1.0, BENCH_POW_FLOOR);
+    }
+
+    S1 = SIM_FeedbackMix(SIM.CurSample - 1);        // Mix used for the last sample of this block
+
+    for (bin = FBC_START_BIN; bin <= FBC_END_BIN; bin++)
+    {
+        Tr = S1*BENCH.TrueR[0][bin] + (1.0 - S1)*BENCH.TrueR[1][bin];
+        Ti = S1*BENCH.TrueI[0][bin] + (1.0 - S1)*BENCH.TrueI[1][bin];
+
+        Fr = 0.0;   Fi = 0.0;
+        for (t = 0; t < FBC.Shape->Taps; t++)
+        {
+            Fr += FBC.Coeffs[t][bin].Real();
+            Fi += FBC.Coeffs[t][bin].Imag();
+        }
+        Fr *= FBC_FILT_SCALE;   Fi *= FBC_FILT_SCALE;
+
+        Dr = Tr - Fr;   Di = Ti - Fi;
+        ErrPow = Dr*Dr + Di*Di;
+        TruePow = Tr*Tr + Ti*Ti;
+
+        BENCH.Cur.BinMisalignDb[bin] = BENCH_Db10(ErrPow, TruePow);
+        SumErr += ErrPow;
+        SumTrue += TruePow;
+        MaxErr = (ErrPow > MaxErr) ? ErrPow : MaxErr;
+        MaxTrue = (TruePow > MaxTrue) ? TruePow : MaxTrue;
+    }
+
+    // Stable gain is the broadband forward gain at which the worst bin reaches unity loop gain; the
+    // forward path is the same with and without FBC, so it drops out of the added stable gain
+    BENCH.Cur.MisalignDb = BENCH_Db10(SumErr, SumTrue);
+    BENCH.Cur.MinMisalignDb = (BENCH.Cur.MisalignDb < BENCH.Cur.MinMisalignDb) ? BENCH.Cur.MisalignDb : BENCH.Cur.MinMisalignDb;
+    BENCH.Cur.MsgOpenDb = -BENCH_Db10(MaxTrue, 1.0);
+    BENCH.Cur.MsgFbcDb = -BENCH_Db10(MaxErr, 1.0);
+    BENCH.Cur.AsgDb = BENCH.Cur.MsgFbcDb - BENCH.Cur.MsgOpenDb;
+
+    if (BENCH.Cur.MisalignDb < BENCH_CONV_THRESH_DB)
+        BENCH.BelowSince = (BENCH.BelowSince == BENCH_NOT_CONVERGED) ? SIM.CurSample : BENCH.BelowSince;
+    else
+        BENCH.BelowSince = BENCH_NOT_CONVERGED;
+
+    BENCH.NumBlocks++;
+}
+
+
+// Call from SIM_CloseSim(). Writes the summary file; one row per feedback path reached
+void BENCH_Report()
+{
+FILE* fp = NULL;
+char fname[256];
+int24_t p, bin;
+strBenchPath* Res;
+
+    if (!BENCH.Enable || (BENCH.NumBlocks == 0))
+        return;
+
+    BENCH_LatchPath();
+
+    sprintf_s(fname, "%s/%s%s", SIM.ResultPath, SIM.FilePrefix, "FBC_Bench.csv");
+    fopen_s(&fp, fname, "w");
+    if (fp == NULL)
+    {
+        printf("\nERROR! Could not open FBC benchmark file %s for write...\n\n", fname);
+        return;
+    }
+
+    fprintf(fp, "FilterShape, %dx%d\n", FBC.Shape->Taps, FBC.Shape->Spacing);
+    fprintf(fp, "AdaptEngine, %d\n", FBC.Engine);
+    fprintf(fp, "AdaptOpsPerBlock, %.0f\n", (double)FBC.AdaptOps/(double)BENCH.NumBlocks);
+    fprintf(fp, "Blocks, %u\n", BENCH.NumBlocks);
+    fprintf(fp, "ConvThreshDb, %.1f\n", BENCH_CONV_THRESH_DB);
+    fprintf(fp, "Path, ConvTimeSec, MinMisalignDb, MisalignDb, MsgOpenDb, MsgFbcDb, AsgDb\n");
+    for (p = 0; p < BENCH.PathsDone; p++)
+    {
+        Res = &BENCH.Result[p];
+        fprintf(fp, "%d, %.4f, %.2f, %.2f, %.2f, %.2f, %.2f\n", p+1,
+            (Res->ConvSample == BENCH_NOT_CONVERGED) ? -1.0 : (double)Res->ConvSample/(double)BASEBAND_SAMPLE_RATE,
+            Res->MinMisalignDb, Res->MisalignDb, Res->MsgOpenDb, Res->MsgFbcDb, Res->AsgDb);
+    }
+    for (p = 0; p < BENCH.PathsDone; p++)
+    {
+        fprintf(fp, "BinMisalignDb%d", p+1);
+        for (bin = FBC_START_BIN; bin <= FBC_END_BIN; bin++)
+            fprintf(fp, ", %.2f", BENCH.Result[p].BinMisalignDb[bin]);
+        fprintf(fp, "\n");
+    }
+    fclose(fp);
+
+    Res = &BENCH.Result[BENCH.PathsDone-1];
+    printf("FBC benchmark: path %d misalignment %.2f dB, added stable gain %.2f dB\n", BENCH.PathsDone, Res->MisalignDb, Res->AsgDb);
+}
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// WDRC characterization
+
+// Put each channel's energy in its first bin, so the channel energy is exactly the bin energy
+static void BENCH_WdrcSetLevel(const double* LevelDb)
+{
+int24_t c, bin;
+
+    for (bin = 0; bin < WOLA_NUM_BINS; bin++)
+        SYS.BinEnergy[bin] = to_frac48(0.0);
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+        SYS.BinEnergy[WDRC.ChannelStartBin[c]] = to_frac48(pow(10.0, LevelDb[c]/10.0));
+    SYS.BinEnergyLog2Valid = 0;
+}
+
+
+// Blocks for every channel to update at least once
+static int24_t BENCH_WdrcCycleBlocks()
+{
+    return (WDRC.UpdateMode == WDRC_UPDATE_ALL) ? WDRC.UpdateDecim : WDRC_NUM_CHANNELS;
+}
+
+
+// Static gain at the level set by BENCH_WdrcSetLevel(): start the level trackers at the channel level the
+// firmware will measure, so no smoothing is involved, then run one update cycle
+static void BENCH_WdrcSettle()
+{
+int24_t c, b;
+
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+        WDRC.LevelLog2[c] = shr(log2_approx((accum_t)SYS.BinEnergy[WDRC.ChannelStartBin[c]]),1);
+    for (b = 0; b < BENCH_WdrcCycleBlocks(); b++)
+        WDRC_Main();
+}
+
+
+// Step the level and time how long each channel gain, and each level tracker, takes to stay within TolDb of
+// its value settled at the new level. -1 if it never does within BENCH_WDRC_STEP_BLOCKS; a gain time of 0
+// means the gain curve changes by less than TolDb over the step.
+static void BENCH_WdrcStep(const double* ToDb, double TolDb, double* GainMs, double* LevelMs)
+{
+frac16_t FinalGain[WDRC_NUM_CHANNELS];
+frac16_t FinalLevel[WDRC_NUM_CHANNELS];
+int24_t LastOut[WDRC_NUM_CHANNELS];
+int24_t LastOutLevel[WDRC_NUM_CHANNELS];
+frac16_t StartGain[WDRC_NUM_CHANNELS];
+frac16_t StartLevel[WDRC_NUM_CHANNELS];
+int24_t c, b;
+
+    // Final gains first; then restore the state at the old level
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+    {
+        StartGain[c] = WDRC.ChanGainLog2[c];
+        StartLevel[c] = WDRC.LevelLog2[c];
+    }
+    BENCH_WdrcSetLevel(ToDb);
+    BENCH_WdrcSettle();
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+    {
+        FinalGain[c] = WDRC.ChanGainLog2[c];
+        FinalLevel[c] = WDRC.LevelLog2[c];
+        WDRC.ChanGainLog2[c] = StartGain[c];
+        WDRC.LevelLog2[c] = StartLevel[c];
+        LastOut[c] = 0;
+        LastOutLevel[c] = 0;
+    }
+    WDRC.CurrentChannel = 0;
+    WDRC.DecimCount = 1;
+
+    for (b = 1; b <= BENCH_WDRC_STEP_BLOCKS; b++)
+    {
+        WDRC_Main();
+        for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+        {
+            LastOut[c] = (fabs(WDRC.ChanGainLog2[c] - FinalGain[c])*BENCH_DB_PER_LOG2 > TolDb) ? b : LastOut[c];
+            LastOutLevel[c] = (fabs(WDRC.LevelLog2[c] - FinalLevel[c])*BENCH_DB_PER_LOG2 > TolDb) ? b : LastOutLevel[c];
+        }
+    }
+
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+    {
+        GainMs[c] = (LastOut[c] == BENCH_WDRC_STEP_BLOCKS) ? -1.0 : 1000.0*(double)(LastOut[c]*BLOCK_SIZE)/(double)BASEBAND_SAMPLE_RATE;
+        LevelMs[c] = (LastOutLevel[c] == BENCH_WDRC_STEP_BLOCKS) ? -1.0 : 1000.0*(double)(LastOutLevel[c]*BLOCK_SIZE)/(double)BASEBAND_SAMPLE_RATE;
+    }
+}
+
+
+// Step levels of each channel, from its knees, so the step crosses the part of the gain curve that moves:
+// low just above the expansion knee, high past the limit knee (at most full scale)
+static void BENCH_WdrcStepLevels(double* LoDb, double* HiDb)
+{
+int24_t c;
+
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+    {
+        LoDb[c] = WDRC.Thresh[c][0]*BENCH_DB_PER_LOG2 + BENCH_WDRC_STEP_MARGIN_DB;
+        HiDb[c] = WDRC.Thresh[c][3]*BENCH_DB_PER_LOG2 + BENCH_WDRC_STEP_MARGIN_DB;
+        HiDb[c] = (HiDb[c] > BENCH_WDRC_SWEEP_MAX_DB) ? BENCH_WDRC_SWEEP_MAX_DB : HiDb[c];
+        LoDb[c] = (LoDb[c] > HiDb[c] - BENCH_WDRC_STEP_MARGIN_DB) ? (HiDb[c] - BENCH_WDRC_STEP_MARGIN_DB) : LoDb[c];
+    }
+}
+
+
+// Command line -w: call after the firmware init, in place of the .wav simulation.
+// Writes <ResultPath>/WDRC_Char.csv: output level vs input level per channel, then the step levels and
+// attack and release times of the channel gains and of the level trackers.
+void BENCH_WdrcChar()
+{
+FILE* fp = NULL;
+char fname[256];
+double SweepDb[WDRC_NUM_CHANNELS];
+double StepLoDb[WDRC_NUM_CHANNELS], StepHiDb[WDRC_NUM_CHANNELS];
+double AttackMs[WDRC_NUM_CHANNELS], LevelAttackMs[WDRC_NUM_CHANNELS];
+double ReleaseMs[WDRC_NUM_CHANNELS], LevelReleaseMs[WDRC_NUM_CHANNELS];
+double InDb;
+int24_t Db;
+int24_t c;
+clock_t Start = clock();
+
+    if (!WDRC_Params.Profile.Enable)
+    {
+        printf("\nWARNING: WDRC characterization needs WDRC enabled; nothing written\n\n");
+        return;
+    }
+
+    sprintf_s(fname, "%s/%s%s", SIM.ResultPath, SIM.FilePrefix, "WDRC_Char.csv");
+    fopen_s(&fp, fname, "w");
+    if (fp == NULL)
+    {
+        printf("\nERROR! Could not open WDRC characterization file %s for write...\n\n", fname);
+        return;
+    }
+
+    fprintf(fp, "UpdateMode, %d\n", WDRC.UpdateMode);
+    fprintf(fp, "UpdateDecim, %d\n", (WDRC.UpdateMode == WDRC_UPDATE_ALL) ? WDRC.UpdateDecim : WDRC_NUM_CHANNELS);
+    fprintf(fp, "InputDb");
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+        fprintf(fp, ", OutDbCh%d", c);
+    fprintf(fp, "\n");
+
+    // Static I/O curves; input is the level WDRC measures, output adds the channel gain
+    for (Db = BENCH_WDRC_SWEEP_MIN_DB; Db <= BENCH_WDRC_SWEEP_MAX_DB; Db += BENCH_WDRC_SWEEP_STEP_DB)
+    {
+        for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+            SweepDb[c] = (double)Db;
+        BENCH_WdrcSetLevel(SweepDb);
+        BENCH_WdrcSettle();
+        fprintf(fp, "%d", Db);
+        for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+        {
+            InDb = WDRC.LevelLog2[c]*BENCH_DB_PER_LOG2;
+            fprintf(fp, ", %.3f", InDb + WDRC.ChanGainLog2[c]*BENCH_DB_PER_LOG2);
+        }
+        fprintf(fp, "\n");
+    }
+
+    // Attack: settle at the low level, step up. Release: step back down from the high level.
+    BENCH_WdrcStepLevels(StepLoDb, StepHiDb);
+    BENCH_WdrcSetLevel(StepLoDb);
+    BENCH_WdrcSettle();
+    BENCH_WdrcStep(StepHiDb, BENCH_WDRC_ATTACK_TOL_DB, AttackMs, LevelAttackMs);
+    BENCH_WdrcStep(StepLoDb, BENCH_WDRC_RELEASE_TOL_DB, ReleaseMs, LevelReleaseMs);
+
+    fprintf(fp, "StepLoDb");
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+        fprintf(fp, ", %.1f", StepLoDb[c]);
+    fprintf(fp, "\nStepHiDb");
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+        fprintf(fp, ", %.1f", StepHiDb[c]);
+    fprintf(fp, "\nAttackMs");
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+        fprintf(fp, ", %.2f", AttackMs[c]);
+    fprintf(fp, "\nReleaseMs");
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+        fprintf(fp, ", %.2f", ReleaseMs[c]);
+    fprintf(fp, "\nLevelAttackMs");
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+        fprintf(fp, ", %.2f", LevelAttackMs[c]);
+    fprintf(fp, "\nLevelReleaseMs");
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+        fprintf(fp, ", %.2f", LevelReleaseMs[c]);
+    fprintf(fp, "\n");
+    fclose(fp);
+
+    printf("WDRC characterization: %d levels x %d channels, channel 0 steps %.1f to %.1f dB, %.3f s\n",
+        (BENCH_WDRC_SWEEP_MAX_DB - BENCH_WDRC_SWEEP_MIN_DB)/BENCH_WDRC_SWEEP_STEP_DB + 1, WDRC_NUM_CHANNELS,
+        StepLoDb[0], StepHiDb[0], (double)(clock() - Start)/(double)CLOCKS_PER_SEC);
+}
@@ -0,0 +1,73 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// FBC benchmark and WDRC characterization (simulation only) header file for fixed-point C code
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#ifndef _BENCH_H
+#define _BENCH_H
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Defines
+
+// The simulated feedback path (SIM.FB_FIR1/FIR2) is transformed into the subband domain at each bin
+// centre and compared against the response of FBC.Coeffs every block. Only the FBC bins are scored.
+#define     BENCH_CONV_THRESH_DB    -10.0       // Misalignment below which FBC counts as converged
+#define     BENCH_NUM_PATHS         2           // FIR1 before the transition, FIR2 from the transition start
+#define     BENCH_NOT_CONVERGED     ((uint32_t)(-1))
+
+// WDRC characterization drives WDRC_Main() directly with synthetic SYS.BinEnergy; no filterbank or .wav file.
+// Levels are channel levels in dBFS, as WDRC sees them (WDRC.ChanEnergyLog2). Attack and release are timed
+// as in ANSI S3.22: from the level step until the channel gain stays within tolerance of its final value.
+#define     BENCH_WDRC_SWEEP_MIN_DB     -100
+#define     BENCH_WDRC_SWEEP_MAX_DB     0
+#define     BENCH_WDRC_SWEEP_STEP_DB    1
+#define     BENCH_WDRC_STEP_MARGIN_DB   10.0    // Step levels per channel: this far above the expansion knee (Thresh0) and the limit knee (Thresh3)
+#define     BENCH_WDRC_ATTACK_TOL_DB    3.0
+#define     BENCH_WDRC_RELEASE_TOL_DB   4.0
+#define     BENCH_WDRC_STEP_BLOCKS      (4*BASEBAND_SAMPLE_RATE/BLOCK_SIZE)     // Run time after each step; 4 s
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Module structure
+
+struct strBenchPath
+{
+    uint32_t    ConvSample;         // Samples from path start until misalignment stayed below threshold; BENCH_NOT_CONVERGED if it never did
+    double      MinMisalignDb;      // Best over the path
+    double      MisalignDb;         // Values at the end of the path
+    double      MsgOpenDb;
+    double      MsgFbcDb;
+    double      AsgDb;
+    double      BinMisalignDb[WOLA_NUM_BINS];
+};
+
+struct strBENCH
+{
+    bool        Enable;
+    double      TrueR[BENCH_NUM_PATHS][WOLA_NUM_BINS];      // True feedback path at bin centres, as seen by FBC.Coeffs
+    double      TrueI[BENCH_NUM_PATHS][WOLA_NUM_BINS];
+    int24_t     Path;               // Path being scored; 0 or 1
+    int24_t     PathsDone;          // Paths with results latched in Result[]
+    uint32_t    PathStart;          // Sample at which the current path started
+    uint32_t    BelowSince;         // Start of the current run below threshold; BENCH_NOT_CONVERGED if above
+    uint32_t    NumBlocks;
+    strBenchPath    Cur;            // Latest block; ConvSample not used
+    strBenchPath    Result[BENCH_NUM_PATHS];
+};
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Function prototypes
+
+void BENCH_Init();
+void BENCH_Update();
+void BENCH_Report();
+void BENCH_WdrcChar();
+
+#endif  // _BENCH_H
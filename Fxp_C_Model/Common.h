@@ -122,19 +122,18 @@ inline frac24_t lower_accum_to_f24(double a)
 }
 
 // Shift left
+// ldexp() scales by an exact power of two, same result as multiplying by pow(2.0, sh) without the pow() call;
+// these run per bin, per block in the smoothers and adaptation
 inline accum_t shl(accum_t a, unsigned sh)
 {
-    double shmul = pow(2.0, sh);
-    accum_t ret = a * shmul;
+    accum_t ret = ldexp(a, (int)sh);
     return ret;
 }
 
 // Shift right
 inline accum_t shr(accum_t a, unsigned sh)
 {
-    int ss = -(int)sh;
-    double shmul = pow(2.0, ss);
-    accum_t ret = a * shmul;
+    accum_t ret = ldexp(a, -(int)sh);
     return ret;
 }
 
@@ -263,6 +262,15 @@ int24_t TC;
 
 }
 
+// Rescale a smoothing coefficient (TC = 1 - decay per update) for updates Rate times as far apart, keeping the
+// time constant in ms:  TC' = 1 - (1 - TC)^Rate. Init only; TODO: do this in the param conversion instead of pow()
+inline frac24_t rescale_TC (frac24_t TC, double Rate)
+{
+frac24_t ret;
+    ret = to_frac24(1.0 - pow(1.0 - TC, Rate));
+    return ret;
+}
+
 
 #include "Complex24Class.h"
 
@@ -304,10 +312,8 @@ int24_t TC;
 
 #define     WDRC_NUM_CHANNELS       8
 
-#define     FBC_COEFFS_PER_BIN      4
-#define     FBC_COEFF_SPACING       2       // Should be either 1 (continguous coeffs) or 2 (zero between each coeff)
-#define     FBC_REV_ANA_BUF_SIZE    8       // MUST BE POWER OF 2 >= (FBC_COEFFS_PER_BIN*FBC_COEFF_SPACING)
-#define     FBC_REV_ANA_SIZE_MASK   (FBC_REV_ANA_BUF_SIZE-1)
+#define     FBC_COEFFS_PER_BIN      4       // Most taps of any FBC filter shape (see FBC_Shapes[] in FBC.cpp); sets coefficient storage
+#define     FBC_REV_ANA_BUF_SIZE    7       // Most frames spanned by any FBC filter shape, (taps-1)*spacing + 1; sets RevAnaBuf storage
 
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -319,11 +325,14 @@ int24_t TC;
 #include "EQ_ParamStruct.h"
 #include "NR_ParamStruct.h"
 
-extern strParams_SYS    SYS_Params;
-extern strParams_WDRC   WDRC_Params;
-extern strParams_FBC    FBC_Params;
-extern strParams_EQ     EQ_Params;
-extern strParams_NR     NR_Params;
+// Parameters and module state are per thread, so that several processing instances (e.g. left and right ears)
+// can each run on their own thread; see MCH.h. A single-instance simulation only uses the main thread's copy.
+
+extern thread_local strParams_SYS    SYS_Params;
+extern thread_local strParams_WDRC   WDRC_Params;
+extern thread_local strParams_FBC    FBC_Params;
+extern thread_local strParams_EQ     EQ_Params;
+extern thread_local strParams_NR     NR_Params;
 
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -334,18 +343,32 @@ extern strParams_NR     NR_Params;
 #include "WDRC.h"
 #include "FBC.h"
 #include "NR.h"
+#include "PIPE.h"
+#include "MCH.h"
 
-extern strSYS   SYS;
-extern strWDRC  WDRC; 
-extern strFBC   FBC;
-extern strNR    NR;
+extern thread_local strSYS   SYS;
+extern thread_local strWDRC  WDRC; 
+extern thread_local strFBC   FBC;
+extern thread_local strNR    NR;
+extern thread_local strPIPE  PIPE;
+extern strMCH   MCH;            // Shared by all instances
 
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // Simulation helper includes, references
 
+#include "TRACE.h"
 #include "SIM.h"
-
-extern  strSIM  SIM;
+#include "BENCH.h"
+#include "FREC.h"
+#include "STAT.h"
+#include "GEN.h"
+
+extern thread_local strSIM  SIM;
+extern thread_local strBENCH BENCH;
+extern thread_local strTRACE TRACE;
+extern thread_local strFREC FREC;
+extern thread_local strSTAT STAT;
+extern thread_local strGEN GEN;
 
 #endif  // _COMMON_H
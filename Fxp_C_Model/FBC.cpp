@@ -11,6 +11,10 @@
 
 #include "Common.h"
 
+static const strFbcShape* FBC_GetShape();
+static int24_t FBC_GetEngine();
+static int24_t FBC_AdaptOpsPerBin(const strFbcShape* Shape, int24_t Engine);
+
 
 void FBC_Init()
 {
@@ -19,7 +23,8 @@ int24_t bin;
 int24_t i;
 frac16_t WdrcMaxGainLog2;
 frac16_t BbTargetGainLog2;
-frac16_t TargetGainBinLog2;
+frac16_t TargetGainChLog2[WDRC_NUM_CHANNELS];
+frac16_t GateThresh;
 
 /*Gains in forward path, per bin:
     WDRC    EQ      NR      filterbank_gain
@@ -45,16 +50,34 @@ then we could miss gains that are turned down as it swamps their negative gain (
         }
         else
             WdrcMaxGainLog2 = to_frac16(0);
-        TargetGainBinLog2 = BbTargetGainLog2 + WdrcMaxGainLog2;
-    // Now distribute gain across all bins in that channel
-        for (bin = WDRC.ChannelStartBin[CurCh]; bin <= WDRC.ChannelLastBin[CurCh]; bin++)
-            FBC.TargetGainLog2[bin] = TargetGainBinLog2;
+        TargetGainChLog2[CurCh] = BbTargetGainLog2 + WdrcMaxGainLog2;
     }
+    // Now distribute gain across all bins of each channel; WDRC_Init() has set the channel map
+    for (bin = 0; bin < WOLA_NUM_BINS; bin++)
+        FBC.TargetGainLog2[bin] = TargetGainChLog2[WDRC.BinChannel[bin]];
+
+    FBC.Shape = FBC_GetShape();
+    FBC.Engine = FBC_GetEngine();
+    FBC.Adapt = FBC.Shape->Adapt[FBC.Engine];
+    FBC.AdaptOpsPerBin = FBC_AdaptOpsPerBin(FBC.Shape, FBC.Engine);
+    FBC.AdaptOps = 0;
 
     FBC.StartBin = FBC_START_BIN;
     FBC.EndBin = (FBC_START_BIN + FBC_BINS_PER_CALL - 1);
     FBC.EndBin = (FBC.EndBin > FBC_END_BIN) ? FBC_END_BIN : FBC.EndBin;
 
+    GateThresh = (FBC_Params.Profile.AdaptGateThresh < 0) ? FBC_Params.Profile.AdaptGateThresh : FBC_GATE_DEF_THRESH;     // 0 gates every bin
+    FBC.GateThreshLin = to_frac48(pow(2.0, GateThresh));   // TODO: Use exp2 approximation for fixed point
+    FBC.GatedCount = 0;
+    FBC.AdaptCount = 0;
+    for (bin = 0; bin < WOLA_NUM_BINS; bin++)
+    {
+        FBC.SchedNeed[bin] = to_frac24(0);
+        FBC.SchedResp[bin].SetVal(to_frac24(0), to_frac24(0));
+        FBC.SchedDrift[bin].SetVal(to_frac24(0), to_frac24(0));
+        FBC.SchedStepSize[bin] = to_frac24(0);
+    }
+
     // Set adapt speeds, clear gain limit
     // Zero out coeffs and set CoefMag to low value
     for (bin = 0; bin < WOLA_NUM_BINS; bin++)
@@ -62,7 +85,7 @@ then we could miss gains that are turned down as it swamps their negative gain (
         FBC.AdaptShift[bin] = FBC_Params.Profile.ActiveShift;   // used for debug tracking, give it some value
         FBC.GainLimLog2[bin] = to_frac16(0);                    // Set to unity (max)
         for (i = 0; i < FBC_COEFFS_PER_BIN; i++)
-            FBC.Coeffs[bin][i].SetVal(to_frac24(0), to_frac24(0));
+            FBC.Coeffs[i][bin].SetVal(to_frac24(0), to_frac24(0));
         FBC.CoefMag[bin] = to_frac16(-23.0);
 
         FBC.FiltSig[bin] = to_frac24(0.0);
@@ -109,40 +132,389 @@ int24_t i;
 }
 
 
-void FBC_HEAR_DoFiltering()
+// Subband FIR across all bins, one tap row at a time, for a filter shape of Taps taps Spacing frames
+// apart. Tap row pointers into the circular RevAnaBuf are found once per block; the per-bin accumulate
+// order is the same as a bin-by-bin loop, and the headroom shift and saturation are folded into the
+// last tap. Taps is a compile-time constant, so the tap loops unroll.
+template <int Taps, int Spacing>
+static void FBC_FilterLanes()
 {
+const int24_t Span = FBC_SHAPE_SPAN(Taps, Spacing);
+const int24_t Frames = SYS.RevAnaFrames;            // Ring depth
 int24_t bin;
 int24_t cf;
 int24_t BufDly;
+Complex24* B[Taps];                 // Row of B[n-c] across bins, for each tap
+Complex24* C;
+accum_t AccR[WOLA_NUM_BINS];
+accum_t AccI[WOLA_NUM_BINS];
 accum_t Ar, Ai;
 frac24_t Sr, Si;
 frac24_t Cr, Ci;
 
-    // Filter the subband version of the fed-back output by the FBC coefficients
+    static_assert((Taps <= FBC_COEFFS_PER_BIN) && (Span <= FBC_REV_ANA_BUF_SIZE), "FBC filter shape does not fit storage; raise FBC_COEFFS_PER_BIN or FBC_REV_ANA_BUF_SIZE");
+
+    BufDly = SYS.RevAnaPtr;
+    for (cf = 0; cf < Taps; cf++)
+    {
+        B[cf] = SYS.RevAnaBuf[BufDly];
+        BufDly -= Spacing;
+        BufDly = (BufDly < 0) ? (BufDly + Frames) : BufDly;
+    }
 
     for (bin = 0; bin < WOLA_NUM_BINS; bin++)
     {
-        Ar = to_accum(0);   Ai = to_accum(0);
-        BufDly = SYS.RevAnaPtr;
-        for (cf = 0; cf < FBC_COEFFS_PER_BIN; cf++)
+        AccR[bin] = to_accum(0);    AccI[bin] = to_accum(0);
+    }
+
+    for (cf = 0; cf < Taps-1; cf++)
+    {
+        C = FBC.Coeffs[cf];
+        for (bin = 0; bin < WOLA_NUM_BINS; bin++)
         {
-            Sr = SYS.RevAnaBuf[BufDly][bin].Real(); Si = SYS.RevAnaBuf[BufDly][bin].Imag();
-            BufDly = (BufDly-FBC_COEFF_SPACING)&FBC_REV_ANA_SIZE_MASK;
-            Cr = FBC.Coeffs[bin][cf].Real();        Ci = FBC.Coeffs[bin][cf].Imag();
-            Ar += Sr * Cr;      Ai += Sr * Ci;
-            Ar -= Si * Ci;      Ai += Si * Cr;
+            Sr = B[cf][bin].Real();     Si = B[cf][bin].Imag();
+            Cr = C[bin].Real();         Ci = C[bin].Imag();
+            Ar = AccR[bin];             Ai = AccI[bin];
+            Ar += Sr * Cr;              Ai += Sr * Ci;
+            Ar -= Si * Ci;              Ai += Si * Cr;
+            AccR[bin] = Ar;             AccI[bin] = Ai;
         }
-    // Give some headroom to coefficients; by shifting left here, we make larger the value which is subtracted
+    }
+
+    // Last tap; give some headroom to coefficients. By shifting left here, we make larger the value which is subtracted
     // to create Error, meaning more cancellation, meaning the coefficients will adapt to be smaller to balance
-        Ar = shl(Ar, FBC_FILT_SHIFT);   Ai = shl(Ai, FBC_FILT_SHIFT);
-        FBC.FiltSig[bin].SetVal(rnd_sat24(Ar), rnd_sat24(Ai));
+    C = FBC.Coeffs[Taps-1];
+    for (bin = 0; bin < WOLA_NUM_BINS; bin++)
+    {
+        Sr = B[Taps-1][bin].Real(); Si = B[Taps-1][bin].Imag();
+        Cr = C[bin].Real();         Ci = C[bin].Imag();
+        Ar = AccR[bin];             Ai = AccI[bin];
+        Ar += Sr * Cr;              Ai += Sr * Ci;
+        Ar -= Si * Ci;              Ai += Si * Cr;
+        FBC.FiltSig[bin].SetVal(rnd_sat24(Ar * FBC_FILT_SCALE), rnd_sat24(Ai * FBC_FILT_SCALE));
     }
 }
 
 
+void FBC_HEAR_DoFiltering()
+{
+int24_t bin;
+
+    // Filter the subband version of the fed-back output by the FBC coefficients
+
+    // Low-power path: every frame the filter reads is zero (or, in approximate mode, the block is quiet)
+    if ((SYS.RevQuietFrames >= SYS.RevAnaFrames) || (SYS.QuietBlock && (SYS.LowPowerMode == SYS_LOWPWR_APPROX)))
+    {
+        for (bin = 0; bin < WOLA_NUM_BINS; bin++)
+            FBC.FiltSig[bin] = to_frac24(0.0);
+        return;
+    }
+
+    FBC.Shape->Filter();
+}
+
+
+// NLMS coefficient update for the bins in Bins[], one tap row at a time across bins, for a filter
+// shape of Taps taps Spacing frames apart.
+// Per-lane mu and leakage shifts come in as power-of-two scales (exact for doubles), so the inner
+// loop is branch-free apart from saturation and can be run as SIMD lanes (with a gather by bin).
+// Leaves the sum of the new coefficients of each lane in SumR/SumI.
+template <int Taps, int Spacing>
+static void FBC_AdaptLanes(const int24_t* Bins, int24_t NumBins, const accum_t* MuScale, const accum_t* LeakScale, frac24_t* SumR, frac24_t* SumI)
+{
+const int24_t Frames = SYS.RevAnaFrames;
+int24_t ln;         // Lane
+int24_t bin;
+int24_t cf;
+int24_t BufDly;     // Delay into output analysis buffer (treats buffer as FIFO, with newest value at offset 0)
+Complex24* B;
+Complex24* C;
+accum_t Ar, Ai;
+frac24_t Br, Bi;
+frac24_t Cr, Ci;
+frac24_t Er, Ei;
+frac24_t Tr, Ti;
+
+    for (ln = 0; ln < NumBins; ln++)
+    {
+        SumR[ln] = to_frac24(0);        SumI[ln] = to_frac24(0);    // Clear out coeff sum
+    }
+
+    BufDly = SYS.RevAnaPtr;
+    for (cf = 0; cf < Taps; cf++)
+    {
+        B = SYS.RevAnaBuf[BufDly];      // Row of B[n-c] across bins
+        C = FBC.Coeffs[cf];             // Row of tap c across bins
+        BufDly -= Spacing;
+        BufDly = (BufDly < 0) ? (BufDly + Frames) : BufDly;
+
+        for (ln = 0; ln < NumBins; ln++)
+        {
+        // FBC.Coeffs[c][n] = FBC.Coeffs[c][n-1]*Leak + (Err[n]*conj(B[n-c]))>>norm_and_mu_shift
+        // (Br - j*Bi)*(Er + j*Ei) = (Br*Er + Bi*Ei) + j*(Br*Ei - Bi*Er)
+            bin = Bins[ln];
+            Er = SYS.Error[bin].Real(); Ei = SYS.Error[bin].Imag();
+            Br = B[bin].Real();         Bi = B[bin].Imag();
+            Ar  = Br * Er;              Ai  = Br * Ei;
+            Ar += Bi * Ei;              Ai -= Bi * Er;
+            Ar = Ar * MuScale[ln];      Ai = Ai * MuScale[ln];          // shs(x, MuShift)
+            Cr = C[bin].Real();         Ci = C[bin].Imag();
+            Ar += Cr;                   Ai += Ci;
+            Ar -= Cr * LeakScale[ln];   Ai -= Ci * LeakScale[ln];       // shr(C, LeakSh)
+            Tr = rnd_sat24(Ar);         Ti = rnd_sat24(Ai);             // Back to single precision
+            SumR[ln] += Tr;             SumI[ln] += Ti;                 // Sum the new coefficients in this bin
+            C[bin].SetVal(Tr, Ti);                                      // Update the coefficients
+        }
+    }
+}
+
+
+// Proportionate NLMS (IPNLMS) update: as FBC_AdaptLanes(), with the step of each tap weighted by its share
+// of the bin's coefficient magnitude (L1, before the update). The weights of a bin add up to Taps, so the
+// MuShift normalization keeps its meaning; with all coefficients at 0 every weight is 1 (plain NLMS).
+// FBC_PNLMS_ALPHA sets the mix between uniform and proportionate weights.
+template <int Taps, int Spacing>
+static void FBC_AdaptLanesPnlms(const int24_t* Bins, int24_t NumBins, const accum_t* MuScale, const accum_t* LeakScale, frac24_t* SumR, frac24_t* SumI)
+{
+const int24_t Frames = SYS.RevAnaFrames;
+int24_t ln;
+int24_t bin;
+int24_t cf;
+int24_t BufDly;
+Complex24* B;
+Complex24* C;
+accum_t Ar, Ai;
+accum_t Mag[Taps][FBC_BINS_PER_CALL];
+accum_t MagSum, Norm;
+frac24_t Br, Bi;
+frac24_t Cr, Ci;
+frac24_t Er, Ei;
+frac24_t Tr, Ti;
+
+    // Per-tap weights from the current coefficients; one reciprocal per lane
+    for (ln = 0; ln < NumBins; ln++)
+    {
+        bin = Bins[ln];
+        MagSum = to_accum(0);
+        for (cf = 0; cf < Taps; cf++)
+        {
+            Mag[cf][ln] = abs_f24(FBC.Coeffs[cf][bin].Real()) + abs_f24(FBC.Coeffs[cf][bin].Imag()) + FBC_PNLMS_EPS;
+            MagSum += Mag[cf][ln];
+        }
+        Norm = (1.0 + FBC_PNLMS_ALPHA)*0.5*(accum_t)Taps/MagSum;
+        for (cf = 0; cf < Taps; cf++)
+            Mag[cf][ln] = ((1.0 - FBC_PNLMS_ALPHA)*0.5 + Mag[cf][ln]*Norm)*MuScale[ln];
+        SumR[ln] = to_frac24(0);        SumI[ln] = to_frac24(0);
+    }
+
+    BufDly = SYS.RevAnaPtr;
+    for (cf = 0; cf < Taps; cf++)
+    {
+        B = SYS.RevAnaBuf[BufDly];
+        C = FBC.Coeffs[cf];
+        BufDly -= Spacing;
+        BufDly = (BufDly < 0) ? (BufDly + Frames) : BufDly;
+
+        for (ln = 0; ln < NumBins; ln++)
+        {
+            bin = Bins[ln];
+            Er = SYS.Error[bin].Real(); Ei = SYS.Error[bin].Imag();
+            Br = B[bin].Real();         Bi = B[bin].Imag();
+            Ar  = Br * Er;              Ai  = Br * Ei;
+            Ar += Bi * Ei;              Ai -= Bi * Er;
+            Ar = Ar * Mag[cf][ln];      Ai = Ai * Mag[cf][ln];          // Weighted shs(x, MuShift)
+            Cr = C[bin].Real();         Ci = C[bin].Imag();
+            Ar += Cr;                   Ai += Ci;
+            Ar -= Cr * LeakScale[ln];   Ai -= Ci * LeakScale[ln];       // shr(C, LeakSh)
+            Tr = rnd_sat24(Ar);         Ti = rnd_sat24(Ai);
+            SumR[ln] += Tr;             SumI[ln] += Ti;
+            C[bin].SetVal(Tr, Ti);
+        }
+    }
+}
+
+
+// Filter shapes available through FBC_Params.Persist.FilterShape. Spacing 2 halves the taps needed
+// to cover a given feedback path length, at the cost of a coarser fit.
+static const strFbcShape FBC_Shapes[FBC_NUM_SHAPES] =
+{
+//    Taps  Spacing     Filter                  Adapt: NLMS             PNLMS
+    { 4,    2,          FBC_FilterLanes<4, 2>,  { FBC_AdaptLanes<4, 2>, FBC_AdaptLanesPnlms<4, 2> } },    // Default
+    { 4,    1,          FBC_FilterLanes<4, 1>,  { FBC_AdaptLanes<4, 1>, FBC_AdaptLanesPnlms<4, 1> } },
+    { 3,    2,          FBC_FilterLanes<3, 2>,  { FBC_AdaptLanes<3, 2>, FBC_AdaptLanesPnlms<3, 2> } },
+    { 2,    2,          FBC_FilterLanes<2, 2>,  { FBC_AdaptLanes<2, 2>, FBC_AdaptLanesPnlms<2, 2> } },
+};
+
+
+// Cost of one adapted bin for each engine, in real multiplies (a reciprocal counts FBC_COST_RECIP).
+// MuShift and leakage selection are common to all engines and not counted.
+//   NLMS:  per tap conj(B)*E 4, mu 2, leak 2
+//   PNLMS: NLMS + per tap |C| 1, weight 3; per bin reciprocal and norm 2
+static const strFbcEngineCost FBC_EngineCost[FBC_NUM_ENGINES] =
+{
+//    PerTap    PerBin
+    { 8,        0 },
+    { 12,       FBC_COST_RECIP + 2 },
+};
+
+
+static int24_t FBC_AdaptOpsPerBin(const strFbcShape* Shape, int24_t Engine)
+{
+    return FBC_EngineCost[Engine].PerTap*Shape->Taps + FBC_EngineCost[Engine].PerBin;
+}
+
+
+static const strFbcShape* FBC_GetShape()
+{
+int24_t Idx = FBC_Params.Persist.FilterShape;
+
+    Idx = ((Idx < 0) || (Idx >= FBC_NUM_SHAPES)) ? 0 : Idx;     // Fall back to default shape on bad param
+    return &FBC_Shapes[Idx];
+}
+
+
+static int24_t FBC_GetEngine()
+{
+int24_t Engine = FBC_Params.Persist.AdaptEngine;
+
+    return ((Engine < 0) || (Engine >= FBC_NUM_ENGINES)) ? FBC_ENGINE_NLMS : Engine;
+}
+
+
+// Depth of the reverse analysis ring for the selected shape; called from SYS_Init()
+int24_t FBC_RevAnaFrames()
+{
+const strFbcShape* Shape = FBC_GetShape();
+
+    return FBC_SHAPE_SPAN(Shape->Taps, Shape->Spacing);
+}
+
+
+// Adaptation gating: no loudspeaker excitation in this bin, or B+E energy at the normalization floor.
+// Either way the update would be negligible.
+static bool FBC_AdaptGated(int24_t bin)
+{
+    return ((SYS.RevEnergy[bin] < FBC.GateThreshLin) || (FBC.BESmoothed[bin] < FBC_BE_FLOOR));
+}
+
+
+// Need of a bin just adapted. While a bin converges, its updates move the response the same way and the smoothed
+// step (drift) stays near the step size; once converged they jitter and the drift falls well below it. Need is
+// the drift, 0 below half the step size; boosted while the error is well above its smoothed level or the gain is
+// near the FBC limit. Only the bins adapted this block are rescored, with no multiplies.
+static void FBC_UpdateNeed(int24_t bin, frac24_t Sr, frac24_t Si)
+{
+frac24_t Dr, Di;
+frac24_t Mr, Mi;
+frac24_t Need;
+frac16_t Headroom;
+
+    Dr = Sr - FBC.SchedResp[bin].Real();    Di = Si - FBC.SchedResp[bin].Imag();
+    FBC.SchedResp[bin].SetVal(Sr, Si);
+
+    Mr = FBC.SchedDrift[bin].Real();        Mi = FBC.SchedDrift[bin].Imag();
+    Mr += shr(Dr - Mr, FBC_SCHED_DRIFT_SHIFT);
+    Mi += shr(Di - Mi, FBC_SCHED_DRIFT_SHIFT);
+    FBC.SchedDrift[bin].SetVal(Mr, Mi);
+    FBC.SchedStepSize[bin] += shr(abs_f24(Dr) + abs_f24(Di) - FBC.SchedStepSize[bin], FBC_SCHED_DRIFT_SHIFT);
+
+    Need = abs_f24(Mr) + abs_f24(Mi);
+    if (Need < shr(FBC.SchedStepSize[bin], 1))
+        Need = to_frac24(0);
+    else if (SYS.BinEnergy[bin] >= shl(FBC.ESmoothed[bin], 2))     // ESmoothed tracks 0.5*BinEnergy
+        Need = shl(Need, FBC_SCHED_BOOST_SHIFT);
+    else if (FBC_Params.Profile.GainLimitEnable)
+    {
+        Headroom = FBC.GainLimLog2[bin] - (SYS.DynamicGainLog2[bin] + EQ_Params.Profile.BinGain[bin] + WOLA_FILTBANK_GAIN_LOG2);
+        if (Headroom < FBC_SCHED_LIMIT_MARGIN)
+            Need = shl(Need, FBC_SCHED_BOOST_SHIFT);
+    }
+    FBC.SchedNeed[bin] = Need;
+}
+
+
+// Up to FBC_SCHED_NEED_SLOTS ungated bins of highest need, kept in order as the bins are passed once; then
+// round robin from StartBin over the bins not taken. Ties go to the lower bin.
+static int24_t FBC_BuildNeedList(int24_t* Bins)
+{
+int24_t bin;
+int24_t ln;
+int24_t Scanned;
+int24_t NumBins = 0;
+bool Taken[WOLA_NUM_BINS];
+
+    for (bin = FBC_START_BIN; bin <= FBC_END_BIN; bin++)
+    {
+        Taken[bin] = (FBC_Params.Profile.AdaptGateMode != FBC_GATE_OFF) && FBC_AdaptGated(bin);
+        if (Taken[bin])
+            FBC.GatedCount++;
+        else if ((FBC.SchedNeed[bin] > 0) && ((NumBins < FBC_SCHED_NEED_SLOTS) || (FBC.SchedNeed[bin] > FBC.SchedNeed[Bins[NumBins-1]])))
+        {
+            ln = (NumBins < FBC_SCHED_NEED_SLOTS) ? NumBins++ : (NumBins - 1);
+            for (; (ln > 0) && (FBC.SchedNeed[bin] > FBC.SchedNeed[Bins[ln-1]]); ln--)
+                Bins[ln] = Bins[ln-1];
+            Bins[ln] = bin;
+        }
+    }
+    for (ln = 0; ln < NumBins; ln++)
+        Taken[Bins[ln]] = true;
+
+    bin = FBC.StartBin;
+    for (Scanned = 0; (Scanned < FBC_NUM_ADAPT_BINS) && (NumBins < FBC_BINS_PER_CALL); Scanned++)
+    {
+        if (!Taken[bin])
+        {
+            Bins[NumBins++] = bin;
+            FBC.EndBin = bin;
+        }
+        bin = (bin == FBC_END_BIN) ? FBC_START_BIN : (bin + 1);
+    }
+    return NumBins;
+}
+
+
+// Collect the bins to adapt this block into Bins[]; returns the count (at most FBC_BINS_PER_CALL)
+static int24_t FBC_BuildAdaptList(int24_t* Bins)
+{
+int24_t bin;
+int24_t Scanned;
+int24_t NumBins = 0;
+
+    if (FBC_Params.Profile.AdaptSchedMode == FBC_SCHED_NEED)
+        NumBins = FBC_BuildNeedList(Bins);
+    else if (FBC_Params.Profile.AdaptGateMode == FBC_GATE_REALLOC)
+    {
+    // Walk forward from StartBin, wrapping, until the window is full or every bin has been looked at
+        bin = FBC.StartBin;
+        for (Scanned = 0; (Scanned < FBC_NUM_ADAPT_BINS) && (NumBins < FBC_BINS_PER_CALL); Scanned++)
+        {
+            if (FBC_AdaptGated(bin))
+                FBC.GatedCount++;
+            else
+                Bins[NumBins++] = bin;
+            FBC.EndBin = bin;
+            bin = (bin == FBC_END_BIN) ? FBC_START_BIN : (bin + 1);
+        }
+    }
+    else
+    {
+        for (bin = FBC.StartBin; bin <= FBC.EndBin; bin++)
+        {
+            if ((FBC_Params.Profile.AdaptGateMode == FBC_GATE_SKIP) && FBC_AdaptGated(bin))
+                FBC.GatedCount++;
+            else
+                Bins[NumBins++] = bin;
+        }
+    }
+    FBC.AdaptCount += NumBins;
+    return NumBins;
+}
+
+
 void FBC_FilterAdaptation()
 {
 int24_t bin;
+int24_t ln;
 int24_t cf;
 int24_t MuNorm;
 int24_t GainMuAdj;
@@ -150,18 +522,27 @@ frac48_t ASmoothShifted;
 int24_t LeakSh;
 frac16_t DynBinGainLog2;
 int24_t MuShift;
-frac24_t Er, Ei;
-accum_t Ar, Ai;
-frac24_t Br, Bi;
-accum_t Cr, Ci;
+accum_t Ar;
 frac24_t Sr, Si;
-frac24_t Tr, Ti;
-int24_t BufDly;     // Delay into output analysis buffer (treats buffer as FIFO, with newest value at offset 0)
+int24_t NumBins;
+int24_t Bins[FBC_BINS_PER_CALL];        // Bins adapted this block, one per lane
+accum_t MuScale[FBC_BINS_PER_CALL];     // Per-lane 2^-MuShift
+accum_t LeakScale[FBC_BINS_PER_CALL];   // Per-lane 2^-LeakSh
+frac24_t SumR[FBC_BINS_PER_CALL];
+frac24_t SumI[FBC_BINS_PER_CALL];
 
     if (FBC_Params.Profile.Enable)
     {
-        for (bin = FBC.StartBin; bin <= FBC.EndBin; bin++)
+        // Approximate low-power mode freezes the coefficients on quiet blocks; the bin window still moves on
+        if (SYS.QuietBlock && (SYS.LowPowerMode == SYS_LOWPWR_APPROX))
+            NumBins = 0;
+        else
+            NumBins = FBC_BuildAdaptList(Bins);
+
+        for (ln = 0; ln < NumBins; ln++)
         {
+            bin = Bins[ln];
+
         // Determine MuShift, based on log2(||B+E||^2), per-bin offset, gain below target, and mu parameter
 
             DynBinGainLog2 = SYS.AgcoGainLog2 + SYS.MicCalGainLog2 + WDRC.BinGainLog2[bin] + NR.BinGainLog2[bin];   // Collect active gains
@@ -191,31 +572,24 @@ int24_t BufDly;     // Delay into output analysis buffer (treats buffer as FIFO,
                     LeakSh = FBC.IntermLeak;
             }
 
+            MuScale[ln] = shs(1.0, MuShift);
+            LeakScale[ln] = shr(1.0, LeakSh);
+        }
+
         // Update coefficients using nMLS equation, with leakage on the previous coefficients; for each bin:
         // C[k][n] = C[k][n-1]*Leakage + mu*conj(E[n])*B[n-k], where mu is normalization shift created as shown above
         // k is the coefficient index, n is time index (the bin index is not shown)
         // Also sum up the coefficients in the complex domain to get the response in the center of the bin
 
-            Er = SYS.Error[bin].Real();     Ei = SYS.Error[bin].Imag();     // get current error signal
-            Sr = to_frac24(0);              Si = to_frac24(0);              // Clear out coeff sum
-            BufDly = SYS.RevAnaPtr;
-            for (cf = 0; cf < FBC_COEFFS_PER_BIN; cf++)
-            {
-            // FBC.Coeffs[c][n] = FBC.Coeffs[c][n-1]*Leak + (Err[n]*conj(B[n-c]))>>norm_and_mu_shift
-            // (Br - j*Bi)*(Er + j*Ei) = (Br*Er + Bi*Ei) + j*(Br*Ei - Bi*Er)
-                Br = SYS.RevAnaBuf[BufDly][bin].Real();  Bi = SYS.RevAnaBuf[BufDly][bin].Imag();    BufDly = (BufDly-FBC_COEFF_SPACING)&FBC_REV_ANA_SIZE_MASK;
-                Ar  = Br * Er;              Ai  = Br * Ei;
-                Ar += Bi * Ei;              Ai -= Bi * Er;
-                Ar = shs(Ar, MuShift);      Ai = shs(Ai, MuShift);
-                Cr = FBC.Coeffs[bin][cf].Real();        Ci = FBC.Coeffs[bin][cf].Imag();
-                Ar += Cr;                   Ai += Ci;               // TODO: Determine if multiply by leakage is faster than subtract of shift
-                Ar -= shr(Cr, LeakSh);      Ai -= shr(Ci, LeakSh);
-                Tr = rnd_sat24(Ar);         Ti = rnd_sat24(Ai);     // Back to single precision
-                Sr += Tr;                   Si += Ti;               // Sum the new coefficients in this bin
-                FBC.Coeffs[bin][cf].SetVal(Tr, Ti);                 // Update the coefficients
-            }
+        FBC.Adapt(Bins, NumBins, MuScale, LeakScale, SumR, SumI);
+        FBC.AdaptOps += (uint64_t)(NumBins*FBC.AdaptOpsPerBin);
+
+        for (ln = 0; ln < NumBins; ln++)
+        {
+            bin = Bins[ln];
 
         // Estimate FB magnitude in each bin by taking log2(sum(coeffs)) in the bin
+            Sr = SumR[ln];                  Si = SumI[ln];
             Ar = Sr*Sr + Si*Si;
             FBC.CoefMag[bin] = shr(log2_approx(Ar), 1);        // Divide by 2 to account for it being squared magnitude in linear
 
@@ -226,6 +600,9 @@ int24_t BufDly;     // Delay into output analysis buffer (treats buffer as FIFO,
                       + EQ_Params.Profile.BroadbandGain + SYS_Params.Profile.VCGain);
             else
                 FBC.GainLimLog2[bin] = to_frac16(0);    // Max value
+
+            if (FBC_Params.Profile.AdaptSchedMode == FBC_SCHED_NEED)
+                FBC_UpdateNeed(bin, Sr, Si);
         }
 
     // Determine next set of bins to adapt
@@ -243,7 +620,7 @@ int24_t BufDly;     // Delay into output analysis buffer (treats buffer as FIFO,
         {
             FBC.GainLimLog2[bin] = to_frac16(0);
             for (cf = 0; cf < FBC_COEFFS_PER_BIN; cf++)
-                FBC.Coeffs[bin][cf].SetVal(to_frac24(0), to_frac24(0));
+                FBC.Coeffs[cf][bin].SetVal(to_frac24(0), to_frac24(0));
         }
     }
 }
@@ -17,7 +17,8 @@
 
 #define     FBC_START_BIN               5       // Bin at which adaptation starts (no adaptation below this)
 #define     FBC_END_BIN                 (WOLA_NUM_BINS-1)
-#define     FBC_BINS_PER_CALL           9
+#define     FBC_NUM_ADAPT_BINS          (FBC_END_BIN - FBC_START_BIN + 1)
+#define     FBC_BINS_PER_CALL           9       // Bins adapted per block; all are done in one pass of the lane kernel, see FBC_AdaptLanes()
 
 #define     MAX_GAIN_MU_ADJ             4       // Max amount that gain difference can adjust Mu shift
 #define     FBC_LEVEL_ATK_SHIFT         0
@@ -25,8 +26,58 @@
 
 #define     FBC_FILT_SHIFT              2       // Shift to give some headroom in FBC filter
 #define     FBC_FILT_SHIFT_GAIN_LOG2    to_frac16((double)FBC_FILT_SHIFT)
+#define     FBC_FILT_SCALE              ((accum_t)(1 << FBC_FILT_SHIFT))     // Same as shl(x, FBC_FILT_SHIFT)
 
 #define     FBC_MU_NORM_BIAS            -22     // Power of two limit on normalization Mu
+#define     FBC_BE_FLOOR                ldexp(1.0, FBC_MU_NORM_BIAS)    // BESmoothed below this is at the normalization floor
+
+// Values for FBC_Params.Profile.AdaptGateMode
+#define     FBC_GATE_OFF                0       // Adapt every bin in the window
+#define     FBC_GATE_SKIP               1       // Drop gated bins from the window
+#define     FBC_GATE_REALLOC            2       // Fill the window with the next ungated bins instead
+#define     FBC_GATE_DEF_THRESH         to_frac16(-19.932)  // -60 dBFS, log2 energy; used while AdaptGateThresh is unset (0)
+
+// Values for FBC_Params.Profile.AdaptSchedMode. FBC_SCHED_NEED gives up to FBC_SCHED_NEED_SLOTS of the FBC_BINS_PER_CALL
+// slots to the bins of highest need and fills the rest round robin, so every bin is still adapted at least every
+// FBC_NUM_ADAPT_BINS/(FBC_BINS_PER_CALL - FBC_SCHED_NEED_SLOTS) blocks. Need is only rescored for the bins adapted:
+// a bin has need while its updates keep moving its response the same way (still converging), rather than
+// jittering around it (converged).
+#define     FBC_SCHED_ROUND_ROBIN       0
+#define     FBC_SCHED_NEED              1
+#define     FBC_SCHED_NEED_SLOTS        6
+#define     FBC_SCHED_DRIFT_SHIFT       4       // Smoothing of the update step and its size, per update of the bin
+#define     FBC_SCHED_BOOST_SHIFT       2       // Need x4 while error is 2x above its smoothed level, or gain is near the limit
+#define     FBC_SCHED_LIMIT_MARGIN      to_frac16(1.0)      // 6dB
+
+// Values for FBC_Params.Persist.AdaptEngine; every engine uses the same MuShift normalization and leakage
+#define     FBC_ENGINE_NLMS             0
+#define     FBC_ENGINE_PNLMS            1       // Proportionate NLMS; faster on sparse (few dominant taps) bins
+#define     FBC_NUM_ENGINES             2
+#define     FBC_PNLMS_ALPHA             0.5     // -1 is plain NLMS, 1 is fully proportionate
+#define     FBC_PNLMS_EPS               ldexp(1.0, -10)     // Keeps weights finite and defined with all coefficients at 0
+#define     FBC_COST_RECIP              16      // Cost of a reciprocal in multiplies, for the engine cost model
+
+struct strFbcEngineCost
+{
+    int24_t         PerTap;         // Real multiplies per tap of an adapted bin
+    int24_t         PerBin;         // Extra per adapted bin
+};
+
+
+// Filter shapes. FBC_Params.Persist.FilterShape picks one entry of FBC_Shapes[] (FBC.cpp); each entry
+// has filtering and adaptation kernels (one per engine) compiled for its tap count and spacing.
+#define     FBC_NUM_SHAPES              4
+#define     FBC_SHAPE_SPAN(t, s)        (((t)-1)*(s) + 1)       // Frames of reverse analysis history read by a shape
+
+typedef void (*FbcAdaptKernel)(const int24_t* Bins, int24_t NumBins, const accum_t* MuScale, const accum_t* LeakScale, frac24_t* SumR, frac24_t* SumI);
+
+struct strFbcShape
+{
+    int24_t         Taps;
+    int24_t         Spacing;        // Frames between taps
+    void            (*Filter)();
+    FbcAdaptKernel  Adapt[FBC_NUM_ENGINES];
+};
 
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
@@ -34,12 +85,24 @@
 
 struct strFBC
 {
+    const strFbcShape*  Shape;  // Active filter shape
+    int24_t     Engine;         // Active adaptation engine, FBC_ENGINE_xxx
+    FbcAdaptKernel  Adapt;      // Shape->Adapt[Engine]
+    int24_t     AdaptOpsPerBin; // From the engine cost model
+    uint64_t    AdaptOps;       // Total adaptation cost, for simulation statistics
     int24_t     StartBin;
-    int24_t     EndBin;
+    int24_t     EndBin;         // With FBC_GATE_REALLOC, last bin scanned by the current window
+    frac48_t    GateThreshLin;  // Linear RevEnergy threshold for adaptation gating
+    uint32_t    GatedCount;     // Bins passed over by gating, for simulation statistics
+    uint32_t    AdaptCount;     // Bin updates performed
+    frac24_t    SchedNeed[WOLA_NUM_BINS];       // 0 if converged (FBC_SCHED_NEED)
+    Complex24   SchedResp[WOLA_NUM_BINS];       // Bin response (sum of taps) after its last update
+    Complex24   SchedDrift[WOLA_NUM_BINS];      // Smoothed update step of the response
+    frac24_t    SchedStepSize[WOLA_NUM_BINS];   // Smoothed size (L1) of the update step
     frac24_t    TargetGainLog2[WOLA_NUM_BINS];
     int24_t     IntermLeak;
     int24_t     AdaptShift[WOLA_NUM_BINS];
-    Complex24   Coeffs[WOLA_NUM_BINS][FBC_COEFFS_PER_BIN];
+    Complex24   Coeffs[FBC_COEFFS_PER_BIN][WOLA_NUM_BINS];      // Bin-major: each tap is a row across bins, so adaptation runs across bins. Rows past Shape->Taps stay 0
     frac16_t    CoefMag[WOLA_NUM_BINS];
     Complex24   FiltSig[WOLA_NUM_BINS];
     frac16_t    GainLimLog2[WOLA_NUM_BINS];
@@ -59,6 +122,7 @@ struct strFBC
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // Function prototypes
 
+int24_t FBC_RevAnaFrames();
 void FBC_Init();
 void FBC_HEAR_Levels();
 void FBC_HEAR_DoFiltering();
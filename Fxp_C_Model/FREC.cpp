@@ -0,0 +1,240 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// Flight recorder (simulation only) for fixed-point C code
+// Keeps the last blocks of the selected trace signals in memory and writes them out when a trigger fires
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include "Common.h"
+
+// Names for -F and FREC_Events.csv; in FREC_TRIG_xxx bit order
+const char* const FREC_TriggerNames[FREC_NUM_TRIGGERS] = { "sat", "gainlim", "jump", "howl" };
+
+
+// Call from SIM_Init(), after SIM_OutputFileSetup() has made the signal list
+void FREC_Init()
+{
+const strSimSignal* Sig;
+char fname[256];
+int24_t k;
+
+    FREC.Enable = (SIM.FlightBlocks > 0) && (SIM.NumTraced > 0);
+    FREC.Ring = NULL;
+    FREC.EventFile = NULL;
+    FREC.Blocks = 0;
+    FREC.HoldOff = 0;
+    FREC.NumEvents = 0;
+    for (k = 0; k < FREC_NUM_TRIGGERS; k++)
+        FREC.TrigCount[k] = 0;
+    if (!FREC.Enable)
+        return;
+
+    FREC.Triggers = SIM.FlightTriggers;
+    FREC.NumSignals = SIM.NumTraced;
+    FREC.SlotBytes = 0;
+    for (k = 0; k < FREC.NumSignals; k++)
+    {
+        Sig = SIM_GetSignal(SIM.TraceList[k]);
+        FREC.Signals[k] = Sig;
+        FREC.RowOffset[k] = FREC.SlotBytes;
+        FREC.RowBytes[k] = TRACE_RowBytes(Sig->Type, SIM_SignalWidth(Sig));
+        FREC.SlotBytes += FREC.RowBytes[k];
+    }
+
+    FREC.Depth = SIM.FlightBlocks;
+    if ((uint64_t)FREC.Depth*FREC.SlotBytes > FREC_MAX_RING_BYTES)
+    {
+        FREC.Depth = FREC_MAX_RING_BYTES/FREC.SlotBytes;
+        printf("\nWARNING: flight recorder limited to %u blocks of the selected signals\n\n", FREC.Depth);
+    }
+
+    // The one allocation of the recorder; its size is known only once the signals are selected
+    FREC.Ring = (uint8_t*)malloc((size_t)FREC.Depth*FREC.SlotBytes);
+    if (FREC.Ring == NULL)
+    {
+        printf("\nERROR! Could not allocate %u KB for the flight recorder; not recording...\n\n", (FREC.Depth*FREC.SlotBytes) >> 10);
+        FREC.Enable = false;
+        return;
+    }
+
+    FREC.GainLimited = false;
+    FREC.FastLevel = 0.0;
+    FREC.SlowLevel = 0.0;
+    FREC.FastCoeff = 1.0 - exp(-1.0/(FREC_JUMP_FAST_TC*(double)SUBBAND_SAMPLE_RATE));
+    FREC.SlowCoeff = 1.0 - exp(-1.0/(FREC_JUMP_SLOW_TC*(double)SUBBAND_SAMPLE_RATE));
+    FREC.HowlCoeff = 1.0 - exp(-1.0/(FREC_HOWL_TC*(double)SUBBAND_SAMPLE_RATE));
+    for (k = 0; k < WOLA_NUM_BINS; k++)
+    {
+        FREC.HowlEnergy[k] = 0.0;
+        FREC.HowlRun[k] = 0;
+    }
+
+    sprintf_s(fname, "%s/%s%s", SIM.ResultPath, SIM.FilePrefix, "FREC_Events.csv");
+    fopen_s(&FREC.EventFile, fname, "w");
+    if (FREC.EventFile == NULL)
+        printf("\nERROR! Could not open %s for write...\n\n", fname);
+    else
+        fprintf(FREC.EventFile, "Event, Triggers, Block, TimeSec, FirstBlock, SatSamples, LimitedBins, JumpDb, HowlBin\n");
+
+    printf("Flight recorder: %d signals, last %u blocks (%.3f s), %u KB\n", FREC.NumSignals, FREC.Depth,
+        (double)FREC.Depth/(double)SUBBAND_SAMPLE_RATE, (FREC.Depth*FREC.SlotBytes) >> 10);
+}
+
+
+// Write the kept blocks of every signal as event number FREC.NumEvents
+static void FREC_Dump(uint32_t Fired, int24_t SatSamples, int24_t LimitedBins, double JumpDb, int24_t HowlBin)
+{
+strTrace Tr;
+char Name[64];
+uint32_t First = (FREC.Blocks > FREC.Depth) ? (FREC.Blocks - FREC.Depth) : 0;
+uint32_t b;
+int24_t BlockIdx;
+int24_t k;
+
+    for (k = 0; k < FREC.NumSignals; k++)
+    {
+        sprintf_s(Name, "FREC%02d_%s", FREC.NumEvents, FREC.Signals[k]->Name);
+        TRACE_Open(&Tr, Name, FREC.Signals[k]->Type, SIM_SignalWidth(FREC.Signals[k]));
+        for (b = First; b < FREC.Blocks; b++)
+            TRACE_WriteRows(&Tr, &FREC.Ring[(b % FREC.Depth)*FREC.SlotBytes + FREC.RowOffset[k]], 1);
+        TRACE_Close(&Tr);
+    }
+
+    sprintf_s(Name, "FREC%02d_SIM_BlockIdx", FREC.NumEvents);
+    TRACE_Open(&Tr, Name, TRACE_TYPE_I4, 1);
+    for (b = First; b < FREC.Blocks; b++)
+    {
+        BlockIdx = (int24_t)b;
+        TRACE_WriteRows(&Tr, &BlockIdx, 1);
+    }
+    TRACE_Close(&Tr);
+
+    if (FREC.EventFile != NULL)
+    {
+        fprintf(FREC.EventFile, "%d, ", FREC.NumEvents);
+        for (k = 0, b = 0; k < FREC_NUM_TRIGGERS; k++)
+            if (Fired & (1u << k))
+                fprintf(FREC.EventFile, (b++ > 0) ? "+%s" : "%s", FREC_TriggerNames[k]);
+        fprintf(FREC.EventFile, ", %u, %.6f, %u, %d, %d, %.2f, %d\n", FREC.Blocks - 1,
+            (double)(FREC.Blocks - 1)/(double)SUBBAND_SAMPLE_RATE, First, SatSamples, LimitedBins, JumpDb, HowlBin);
+    }
+
+    FREC.NumEvents++;
+}
+
+
+// Call every block, after the block is processed
+void FREC_Update()
+{
+double Row[TRACE_MAX_ROW_DBL];
+uint8_t* Slot;
+uint32_t Fired = 0;
+int24_t SatSamples = 0;
+int24_t LimitedBins = 0;
+int24_t HowlBin = -1;
+double Energy, JumpDb, Side;
+int24_t k;
+
+    if (!FREC.Enable)
+        return;
+
+    Slot = &FREC.Ring[(FREC.Blocks % FREC.Depth)*FREC.SlotBytes];
+    for (k = 0; k < FREC.NumSignals; k++)
+        memcpy(&Slot[FREC.RowOffset[k]], SIM_SignalRow(FREC.Signals[k], Row), FREC.RowBytes[k]);
+    FREC.Blocks++;
+
+// Saturation: input after the feedback sim, and output
+    for (k = 0; k < BLOCK_SIZE; k++)
+    {
+        SatSamples += ((SYS.InBuf[k] >= MAX_VAL24) || (SYS.InBuf[k] <= MIN_VAL24)) ? 1 : 0;
+        SatSamples += ((SYS.OutBuf[k] >= MAX_VAL24) || (SYS.OutBuf[k] <= MIN_VAL24)) ? 1 : 0;
+    }
+    if (SatSamples > 0)
+        Fired |= FREC_TRIG_SAT;
+
+// FBC gain limit: bins where the limit is below the gain SYS would otherwise apply; fires when limiting starts
+    if (FBC_Params.Profile.Enable)
+    {
+        for (k = 0; k < WOLA_NUM_BINS; k++)
+            if (FBC.GainLimLog2[k] < (SYS.DynamicGainLog2[k] + EQ_Params.Profile.BinGain[k] + WOLA_FILTBANK_GAIN_LOG2))
+                LimitedBins++;
+        if ((LimitedBins > 0) && !FREC.GainLimited)
+            Fired |= FREC_TRIG_GAIN_LIM;
+        FREC.GainLimited = (LimitedBins > 0);
+    }
+
+// Output level jump
+    for (k = 0, Energy = 0.0; k < BLOCK_SIZE; k++)
+        Energy += SYS.OutBuf[k]*SYS.OutBuf[k];
+    Energy /= (double)BLOCK_SIZE;
+    if (FREC.Blocks == 1)
+    {
+        FREC.FastLevel = Energy;
+        FREC.SlowLevel = Energy;
+    }
+    FREC.FastLevel += FREC.FastCoeff*(Energy - FREC.FastLevel);
+    FREC.SlowLevel += FREC.SlowCoeff*(Energy - FREC.SlowLevel);
+    JumpDb = 10.0*log10((FREC.FastLevel + 1e-20)/(FREC.SlowLevel + 1e-20));
+    if ((FREC.Blocks > FREC_JUMP_WARMUP_BLOCKS) && (JumpDb > FREC_JUMP_DB) && (10.0*log10(FREC.FastLevel + 1e-20) > FREC_JUMP_FLOOR_DB))
+        Fired |= FREC_TRIG_JUMP;
+
+// Howling: a bin's error energy far above the bins FREC_HOWL_SPAN away on both sides (a tone also fills the
+// adjacent bins), for long enough to rule out a speech harmonic. Edge bins have no peak to compare against;
+// the low bins would otherwise fire on the speech spectrum tilt. A steady tone input also fires.
+    for (k = 0; k < WOLA_NUM_BINS; k++)
+        FREC.HowlEnergy[k] += FREC.HowlCoeff*(SYS.BinEnergy[k] - FREC.HowlEnergy[k]);
+    for (k = FREC_HOWL_SPAN; k < (WOLA_NUM_BINS - FREC_HOWL_SPAN); k++)
+    {
+        Side = fmax(FREC.HowlEnergy[k - FREC_HOWL_SPAN], FREC.HowlEnergy[k + FREC_HOWL_SPAN]);
+        if ((10.0*log10(FREC.HowlEnergy[k] + 1e-20) > FREC_HOWL_FLOOR_DB) &&
+            (10.0*log10((FREC.HowlEnergy[k] + 1e-20)/(Side + 1e-20)) > FREC_HOWL_RATIO_DB))
+            FREC.HowlRun[k]++;
+        else
+            FREC.HowlRun[k] = 0;
+        if (FREC.HowlRun[k] == FREC_HOWL_HOLD_BLOCKS)
+        {
+            Fired |= FREC_TRIG_HOWL;
+            HowlBin = k;
+        }
+    }
+
+    Fired &= FREC.Triggers;
+    for (k = 0; k < FREC_NUM_TRIGGERS; k++)
+        if (Fired & (1u << k))
+            FREC.TrigCount[k]++;
+
+    if (FREC.HoldOff > 0)
+        FREC.HoldOff--;
+    else if ((Fired != 0) && (FREC.NumEvents < FREC_MAX_EVENTS))
+    {
+        FREC_Dump(Fired, SatSamples, LimitedBins, JumpDb, HowlBin);
+        FREC.HoldOff = FREC.Depth;
+    }
+}
+
+
+// Call from SIM_CloseSim()
+void FREC_Close()
+{
+int24_t k;
+
+    if (!FREC.Enable)
+        return;
+
+    printf("Flight recorder: %d dumps; blocks triggered:", FREC.NumEvents);
+    for (k = 0; k < FREC_NUM_TRIGGERS; k++)
+        if (FREC.Triggers & (1u << k))
+            printf(" %s %u", FREC_TriggerNames[k], FREC.TrigCount[k]);
+    printf("\n");
+
+    if (FREC.EventFile != NULL)
+        fclose(FREC.EventFile);
+    FREC.EventFile = NULL;
+    free(FREC.Ring);
+    FREC.Ring = NULL;
+}
@@ -0,0 +1,90 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// Flight recorder (simulation only) header file for fixed-point C code
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#ifndef _FREC_H
+#define _FREC_H
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Defines
+
+// With -F, the signals selected for tracing (-T, -B) are kept in memory for the last SIM.FlightBlocks blocks
+// instead of being written every block. When a trigger fires, the kept blocks up to and including the
+// triggering block are written as FRECnn_<signal>.npy, and a row is added to FREC_Events.csv.
+#define     FREC_TRIG_SAT           (1u << 0)   // Input (after the FB sim) or output sample at full scale
+#define     FREC_TRIG_GAIN_LIM      (1u << 1)   // FBC gain limit starts cutting the forward gain of a bin
+#define     FREC_TRIG_JUMP          (1u << 2)   // Output level jumps above its recent level
+#define     FREC_TRIG_HOWL          (1u << 3)   // One bin stays far above the others; howling
+#define     FREC_NUM_TRIGGERS       4
+#define     FREC_TRIG_ALL           ((1u << FREC_NUM_TRIGGERS) - 1)
+
+#define     FREC_MAX_EVENTS         16          // Dumps per run; later triggers are only counted
+#define     FREC_MAX_RING_BYTES     (1u << 28)  // Depth is reduced to fit
+
+// Output level jump: fast level (2 ms) above slow level (500 ms), output energy per sample re full scale.
+// Not checked until the slow level has settled.
+#define     FREC_JUMP_FAST_TC       0.002
+#define     FREC_JUMP_SLOW_TC       0.5
+#define     FREC_JUMP_DB            20.0
+#define     FREC_JUMP_FLOOR_DB      -50.0       // Fast level must be above this
+#define     FREC_JUMP_WARMUP_BLOCKS (SUBBAND_SAMPLE_RATE/2)
+
+// Howling: a bin's smoothed error energy (20 ms) above the bins FREC_HOWL_SPAN away, held for 200 ms
+#define     FREC_HOWL_TC            0.02
+#define     FREC_HOWL_SPAN          2
+#define     FREC_HOWL_RATIO_DB      20.0
+#define     FREC_HOWL_FLOOR_DB      -40.0
+#define     FREC_HOWL_HOLD_BLOCKS   (SUBBAND_SAMPLE_RATE/5)
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Module structure
+
+struct strFREC
+{
+    bool        Enable;
+    uint32_t    Depth;              // Blocks kept
+    uint32_t    Triggers;           // FREC_TRIG_xxx bits enabled
+    int24_t     NumSignals;
+    const strSimSignal* Signals[NUM_TRACE_SIGNALS];
+    uint32_t    RowOffset[NUM_TRACE_SIGNALS];       // Of each signal's row within a block's slot
+    uint32_t    RowBytes[NUM_TRACE_SIGNALS];
+    uint32_t    SlotBytes;          // One block, all signals
+    uint8_t*    Ring;               // Depth slots; allocated once at init
+    uint32_t    Blocks;             // Blocks captured; the next slot is Blocks % Depth
+    uint32_t    HoldOff;            // Blocks until a trigger can dump again; the ring then holds no dumped block
+
+// Trigger state
+    bool        GainLimited;        // Some bin was gain limited last block
+    double      FastLevel;          // Output energy per sample, smoothed
+    double      SlowLevel;
+    double      FastCoeff;
+    double      SlowCoeff;
+    double      HowlEnergy[WOLA_NUM_BINS];
+    double      HowlCoeff;
+    uint32_t    HowlRun[WOLA_NUM_BINS];     // Consecutive blocks above the howl ratio
+
+// Results
+    uint32_t    TrigCount[FREC_NUM_TRIGGERS];
+    int24_t     NumEvents;
+    FILE*       EventFile;
+};
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Function prototypes
+
+extern const char* const FREC_TriggerNames[FREC_NUM_TRIGGERS];
+
+void FREC_Init();
+void FREC_Update();
+void FREC_Close();
+
+#endif  // _FREC_H
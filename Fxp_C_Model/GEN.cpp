@@ -0,0 +1,258 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// Test signal generator (simulation only) for fixed-point C code
+// Generates the input in place of a .wav file: tones, noise, sweeps and impulses, with optional level steps
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include "Common.h"
+
+// Names for -g; in GEN_TYPE_xxx order
+static const char* const GEN_TypeNames[] = { "none", "tone", "white", "pink", "sweep", "impulse" };
+
+// Pink noise filter (P. Kellett, refined): one-pole sections on white noise, plus a direct term and a one-sample delayed term
+static const double GEN_PinkPole[GEN_PINK_POLES - 1] = { 0.99886, 0.99332, 0.96900, 0.86650, 0.55000, -0.7616 };
+static const double GEN_PinkGain[GEN_PINK_POLES - 1] = { 0.0555179, 0.0750759, 0.1538520, 0.3104856, 0.5329522, -0.0168980 };
+#define     GEN_PINK_DIRECT         0.5362
+#define     GEN_PINK_DELAYED        0.115926
+
+
+static bool GEN_KeyIs(const char* Tok, size_t Len, const char* Key)
+{
+    return (strlen(Key) == Len) && (strncmp(Tok, Key, Len) == 0);
+}
+
+
+// Parse the -g setting; false if any part of it is not understood
+bool GEN_Parse(const char* Spec)
+{
+const char* Tok;
+const char* Val;
+char* End;
+size_t Len, KeyLen;
+double x;
+int24_t t;
+
+    GEN.Type = GEN_TYPE_NONE;
+    GEN.Freq = GEN_DEF_FREQ;
+    GEN.Freq2 = GEN_DEF_FREQ2;
+    GEN.LevelDb = GEN_DEF_LEVEL_DB;
+    GEN.Dur = 0.0;
+    GEN.Period = 0.0;
+    GEN.Seed = GEN_DEF_SEED;
+    GEN.NumLevels = 0;
+    GEN.SegSec = 1.0;
+
+    Len = strcspn(Spec, ",");
+    for (t = GEN_TYPE_TONE; t <= GEN_TYPE_IMPULSE; t++)
+        if (GEN_KeyIs(Spec, Len, GEN_TypeNames[t]))
+            GEN.Type = t;
+    if (GEN.Type == GEN_TYPE_NONE)
+        return false;
+
+    for (Tok = Spec + Len; *Tok == ','; Tok += Len)
+    {
+        Tok++;
+        Len = strcspn(Tok, ",");
+        Val = (const char*)memchr(Tok, '=', Len);
+        if (Val == NULL)
+            return false;
+        KeyLen = (size_t)(Val - Tok);
+        Val++;
+
+        if (GEN_KeyIs(Tok, KeyLen, "levels"))
+        {
+            for (GEN.NumLevels = 0; ; Val = End + 1)
+            {
+                x = strtod(Val, &End);
+                if ((End == Val) || (GEN.NumLevels == GEN_MAX_LEVELS))
+                    return false;       // Empty field (including after a trailing '/'), or too many
+                GEN.Levels[GEN.NumLevels++] = x;
+                if (*End != '/')
+                    break;
+            }
+            if (End != Tok + Len)
+                return false;
+            continue;
+        }
+
+        x = strtod(Val, &End);
+        if ((End == Val) || (End != Tok + Len))
+            return false;
+        if (GEN_KeyIs(Tok, KeyLen, "f"))
+            GEN.Freq = x;
+        else if (GEN_KeyIs(Tok, KeyLen, "f2"))
+            GEN.Freq2 = x;
+        else if (GEN_KeyIs(Tok, KeyLen, "level"))
+            GEN.LevelDb = x;
+        else if (GEN_KeyIs(Tok, KeyLen, "dur"))
+            GEN.Dur = x;
+        else if (GEN_KeyIs(Tok, KeyLen, "seed") && (x >= 0.0))
+            GEN.Seed = (uint32_t)x;
+        else if (GEN_KeyIs(Tok, KeyLen, "period"))
+            GEN.Period = x;
+        else if (GEN_KeyIs(Tok, KeyLen, "seg"))
+            GEN.SegSec = x;
+        else
+            return false;
+    }
+
+    if ((GEN.Dur > GEN_MAX_DUR_SEC) || (GEN.Period > GEN_MAX_DUR_SEC) || (GEN.SegSec > GEN_MAX_DUR_SEC) ||
+        ((GEN.Dur <= 0.0) && ((double)GEN.NumLevels*GEN.SegSec > GEN_MAX_DUR_SEC)))
+    {
+        printf("\nInput generator dur, period and seg (and levels x seg) are limited to %.0f s\n", GEN_MAX_DUR_SEC);
+        return false;
+    }
+
+    return (GEN.Freq > 0.0) && (GEN.Freq < 0.5*(double)BASEBAND_SAMPLE_RATE) && (GEN.Freq2 > 0.0) && (GEN.Freq2 < 0.5*(double)BASEBAND_SAMPLE_RATE) &&
+        (GEN.Dur >= 0.0) && (GEN.Period >= 0.0) && (GEN.SegSec*(double)BASEBAND_SAMPLE_RATE >= 1.0);
+}
+
+
+// xorshift64*; uniform on (0, 1]
+static double GEN_Uniform()
+{
+    GEN.Rng ^= GEN.Rng >> 12;
+    GEN.Rng ^= GEN.Rng << 25;
+    GEN.Rng ^= GEN.Rng >> 27;
+    return (double)(((GEN.Rng*2685821657736338717ull) >> 11) + 1)*(1.0/9007199254740992.0);
+}
+
+
+// Unit variance; Box-Muller, two values per pair of uniforms
+static double GEN_Gauss()
+{
+double r, a;
+
+    if (GEN.HaveGauss)
+    {
+        GEN.HaveGauss = false;
+        return GEN.NextGauss;
+    }
+    r = sqrt(-2.0*log(GEN_Uniform()));
+    a = 2.0*M_PI*GEN_Uniform();
+    GEN.NextGauss = r*sin(a);
+    GEN.HaveGauss = true;
+    return r*cos(a);
+}
+
+
+static double GEN_Pink()
+{
+double w = GEN_Gauss();
+double y;
+int24_t k;
+
+    for (k = 0, y = 0.0; k < GEN_PINK_POLES - 1; k++)
+    {
+        GEN.Pink[k] = GEN_PinkPole[k]*GEN.Pink[k] + GEN_PinkGain[k]*w;
+        y += GEN.Pink[k];
+    }
+    y += GEN.Pink[GEN_PINK_POLES - 1] + GEN_PINK_DIRECT*w;
+    GEN.Pink[GEN_PINK_POLES - 1] = GEN_PINK_DELAYED*w;
+    return y;
+}
+
+
+// Noise state from the seed; also where the pink calibration restarts from
+static void GEN_ResetNoise()
+{
+int24_t k;
+
+    GEN.Rng = 0x9E3779B97F4A7C15ull*((uint64_t)GEN.Seed + 1);
+    GEN.HaveGauss = false;
+    for (k = 0; k < GEN_PINK_POLES; k++)
+        GEN.Pink[k] = 0.0;
+}
+
+
+static void GEN_SetLevel(uint32_t Sample)
+{
+double Db = (GEN.NumLevels > 0) ? GEN.Levels[(Sample/GEN.SegSamples) % GEN.NumLevels] : GEN.LevelDb;
+
+    GEN.Amp = pow(10.0, Db/20.0);
+}
+
+
+// Call after GEN_Parse(), in place of opening the input .wav file
+void GEN_Init()
+{
+double Sum, x;
+uint32_t n;
+
+    if (GEN.Dur <= 0.0)
+        GEN.Dur = (GEN.NumLevels > 0) ? (double)GEN.NumLevels*GEN.SegSec : GEN_DEF_DUR;
+    GEN.NumSamples = (uint32_t)(GEN.Dur*(double)BASEBAND_SAMPLE_RATE)/BLOCK_SIZE*BLOCK_SIZE;
+    GEN.Sample = 0;
+    GEN.SegSamples = (uint32_t)(GEN.SegSec*(double)BASEBAND_SAMPLE_RATE);
+    GEN.PeriodSamples = (uint32_t)(GEN.Period*(double)BASEBAND_SAMPLE_RATE);
+    GEN.Phase = 0.0;
+    GEN.PhaseInc = 2.0*M_PI*GEN.Freq/(double)BASEBAND_SAMPLE_RATE;
+    GEN.IncRatio = (GEN.NumSamples > 0) ? exp(log(GEN.Freq2/GEN.Freq)/(double)GEN.NumSamples) : 1.0;
+    GEN_SetLevel(0);
+
+    GEN.PinkScale = 1.0;
+    GEN_ResetNoise();
+    if (GEN.Type == GEN_TYPE_PINK)
+    {
+        for (n = 0, Sum = 0.0; n < GEN_PINK_CAL_SAMPLES; n++)
+        {
+            x = GEN_Pink();
+            Sum += x*x;
+        }
+        GEN.PinkScale = 1.0/sqrt(Sum/(double)GEN_PINK_CAL_SAMPLES);
+        GEN_ResetNoise();
+    }
+
+    printf("Input generator: %s, %.3f s (%u samples)\n", GEN_TypeNames[GEN.Type], (double)GEN.NumSamples/(double)BASEBAND_SAMPLE_RATE, GEN.NumSamples);
+}
+
+
+// Next N samples, 24-bit values in 32-bit containers as cWAVops::ReadNVals() gives them; zeros after the end
+void GEN_ReadNVals(uint32_t N, int32_t* Buf)
+{
+const double Scale = 8388608.0;     // 2^23
+double x;
+uint32_t n;
+
+    for (n = 0; n < N; n++, GEN.Sample++)
+    {
+        if (GEN.Sample >= GEN.NumSamples)
+        {
+            Buf[n] = 0;
+            continue;
+        }
+        if ((GEN.NumLevels > 0) && (GEN.Sample % GEN.SegSamples == 0))
+            GEN_SetLevel(GEN.Sample);
+
+        switch (GEN.Type)
+        {
+            case GEN_TYPE_TONE:
+            case GEN_TYPE_SWEEP:
+                x = GEN.Amp*sin(GEN.Phase);
+                GEN.Phase += GEN.PhaseInc;
+                GEN.Phase -= (GEN.Phase >= 2.0*M_PI) ? 2.0*M_PI : 0.0;
+                GEN.PhaseInc *= (GEN.Type == GEN_TYPE_SWEEP) ? GEN.IncRatio : 1.0;
+                break;
+            case GEN_TYPE_WHITE:
+                x = GEN.Amp*M_SQRT1_2*GEN_Gauss();
+                break;
+            case GEN_TYPE_PINK:
+                x = GEN.Amp*M_SQRT1_2*GEN.PinkScale*GEN_Pink();
+                break;
+            default:    // GEN_TYPE_IMPULSE
+                x = ((GEN.PeriodSamples > 0) ? (GEN.Sample % GEN.PeriodSamples == 0) : (GEN.Sample == 0)) ? GEN.Amp : 0.0;
+                break;
+        }
+
+        x = round(x*Scale);
+        x = (x > Scale - 1.0) ? (Scale - 1.0) : x;
+        x = (x < -Scale) ? -Scale : x;
+        Buf[n] = (int32_t)x;
+    }
+}
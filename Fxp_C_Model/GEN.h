@@ -0,0 +1,83 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// Test signal generator (simulation only) header file for fixed-point C code
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#ifndef _GEN_H
+#define _GEN_H
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Defines
+
+// With -g <type>[,<key>=<value>...] the input is generated instead of read from the -s .wav file; mono, 24 bits.
+// Types: tone, white, pink, sweep (logarithmic, f to f2), impulse (every period seconds; 0 for one).
+// Keys:  f, f2 (Hz), level (dBFS), dur (seconds), seed, period (seconds),
+//        levels (dBFS, / separated) and seg (seconds): level steps, seg seconds each, repeated to the end.
+// Levels are re a full-scale sine: the peak of a tone, sweep or impulse; the RMS of noise is that of a tone at the same level.
+#define     GEN_TYPE_NONE           0           // Read the -s .wav file
+#define     GEN_TYPE_TONE           1
+#define     GEN_TYPE_WHITE          2
+#define     GEN_TYPE_PINK           3
+#define     GEN_TYPE_SWEEP          4
+#define     GEN_TYPE_IMPULSE        5
+
+#define     GEN_MAX_LEVELS          64
+#define     GEN_PINK_POLES          7
+#define     GEN_PINK_CAL_SAMPLES    (1 << 18)   // Pink filter output RMS is measured over this many samples at init
+
+#define     GEN_DEF_FREQ            1000.0
+#define     GEN_DEF_FREQ2           10000.0
+#define     GEN_DEF_LEVEL_DB        -20.0
+#define     GEN_DEF_DUR             5.0
+#define     GEN_MAX_DUR_SEC         86400.0     // Keeps dur, period and seg sample counts within uint32_t
+#define     GEN_DEF_SEED            1
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Module structure
+
+struct strGEN
+{
+// Settings from -g
+    int24_t     Type;               // GEN_TYPE_xxx
+    double      Freq;
+    double      Freq2;
+    double      LevelDb;
+    double      Dur;                // 0 until set; then the default depends on the level steps
+    double      Period;
+    uint32_t    Seed;
+    int24_t     NumLevels;          // Level steps; 0 for LevelDb throughout
+    double      Levels[GEN_MAX_LEVELS];
+    double      SegSec;
+
+// State
+    uint32_t    NumSamples;         // Whole blocks
+    uint32_t    Sample;             // Next sample
+    uint32_t    SegSamples;
+    uint32_t    PeriodSamples;
+    double      Amp;                // Peak of the current level; tones, sweeps and impulses
+    double      Phase;              // Radians
+    double      PhaseInc;
+    double      IncRatio;           // Sweep: PhaseInc multiplier per sample
+    uint64_t    Rng;                // xorshift64* state
+    bool        HaveGauss;          // Second value of the last Box-Muller pair is in NextGauss
+    double      NextGauss;
+    double      Pink[GEN_PINK_POLES];
+    double      PinkScale;          // Unit RMS from the pink filter
+};
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Function prototypes
+
+bool GEN_Parse(const char* Spec);
+void GEN_Init();
+void GEN_ReadNVals(uint32_t N, int32_t* Buf);
+
+#endif  // _GEN_H
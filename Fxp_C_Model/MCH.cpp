@@ -0,0 +1,136 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// Multi-instance (multi-channel) processing for fixed-point C code
+// Runs one processing instance per input channel, each on its own thread
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include "Common.h"
+
+static const strSIM*        MCH_CliSim;     // Main thread's SIM; holds the command line settings for all instances
+static thread_local int24_t MCH_Self;       // Instance index of the calling thread
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Instance thread
+
+static void MCH_Worker(int24_t Inst)
+{
+int24_t b;
+
+    MCH_Self = Inst;
+
+    // Firmware init for this thread's instance, then simulation set-up with per-instance file names
+    MCH.InitInstance();
+
+    SIM = *MCH_CliSim;
+    sprintf_s(SIM.FilePrefix, "ch%d_", Inst);
+    SIM_Init();
+    if (Inst == 0)
+        PIPE_PrintSchedule();
+
+    while (1)
+    {
+        MCH.ChunkBarrier.Wait();        // Wait for main thread to fill ChunkBuf
+        if (MCH.Quit)
+            break;
+
+        for (b = 0; b < MCH.ChunkBlocks; b++)
+            MCH.ProcessBlock(&MCH.ChunkBuf[Inst][b*BLOCK_SIZE]);
+
+        MCH.ChunkBarrier.Wait();        // Signal chunk done
+    }
+
+    SIM_CloseSim();
+}
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Main thread functions
+
+void MCH_Init(int24_t NumInst, int24_t LinkMode)
+{
+    MCH.NumInst = (NumInst > MCH_MAX_INSTANCES) ? MCH_MAX_INSTANCES : NumInst;
+    MCH.LinkMode = LinkMode;
+    MCH.ChunkBlocks = 0;
+    MCH.Quit = false;
+    MCH.ChunkBarrier.SetCount(MCH.NumInst + 1);
+    MCH.LinkBarrier.SetCount(MCH.NumInst);
+}
+
+
+// Call AFTER MCH_Init() and parsing the command line; instance inits read both
+void MCH_Start(void (*InitInstance)(), void (*ProcessBlock)(int32_t* Buf))
+{
+int24_t k;
+
+    MCH.InitInstance = InitInstance;
+    MCH.ProcessBlock = ProcessBlock;
+    MCH_CliSim = &SIM;
+
+    for (k = 0; k < MCH.NumInst; k++)
+        MCH.Workers[k] = std::thread(MCH_Worker, k);
+}
+
+
+// Process NumBlocks of interleaved samples in MCH.IoBuf, in place
+void MCH_RunChunk(int24_t NumBlocks)
+{
+int24_t k, n;
+int24_t NumSamples = NumBlocks*BLOCK_SIZE;
+
+    for (n = 0; n < NumSamples; n++)
+        for (k = 0; k < MCH.NumInst; k++)
+            MCH.ChunkBuf[k][n] = MCH.IoBuf[n*MCH.NumInst + k];
+
+    MCH.ChunkBlocks = NumBlocks;
+    MCH.ChunkBarrier.Wait();        // Start instances
+    MCH.ChunkBarrier.Wait();        // Wait until all are done
+
+    for (n = 0; n < NumSamples; n++)
+        for (k = 0; k < MCH.NumInst; k++)
+            MCH.IoBuf[n*MCH.NumInst + k] = MCH.ChunkBuf[k][n];
+}
+
+
+void MCH_Stop()
+{
+int24_t k;
+
+    MCH.Quit = true;
+    MCH.ChunkBarrier.Wait();        // Release instances; they close their files and exit
+    for (k = 0; k < MCH.NumInst; k++)
+        MCH.Workers[k].join();
+}
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Link points; called from the processing schedule on each instance thread
+
+// Share the AGCo level between instances so all apply the same broadband gain decision.
+// Each instance keeps tracking its own level; only the level used for the gain is linked.
+void MCH_LinkAgco()
+{
+int24_t i, k;
+frac16_t Level;
+
+    for (i = 0; i < BLOCK_SIZE; i++)
+        MCH.AgcoLinkLevel[MCH_Self][i] = SYS.AgcoLevelBuf[i];
+
+    MCH.LinkBarrier.Wait();         // All levels published
+
+    for (i = 0; i < BLOCK_SIZE; i++)
+    {
+        Level = MCH.AgcoLinkLevel[0][i];
+        for (k = 1; k < MCH.NumInst; k++)
+            Level = max16(Level, MCH.AgcoLinkLevel[k][i]);
+        SYS.AgcoLevelBuf[i] = Level;
+    }
+
+    MCH.LinkBarrier.Wait();         // All levels read before any instance publishes the next block
+}
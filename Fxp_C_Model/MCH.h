@@ -0,0 +1,105 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// Multi-instance (multi-channel) processing header file for fixed-point C code
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#ifndef _MCH_H
+#define _MCH_H
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Includes
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Defines
+
+// Each channel of the input .wav file is processed by its own instance (SYS, FBC, WDRC, NR, ... and
+// parameters), running on its own thread. Instance state is thread_local; see Common.h.
+#define     MCH_MAX_INSTANCES       8
+#define     MCH_CHUNK_BLOCKS        256         // Blocks handed to the instances per .wav read/write
+
+#define     MCH_LINK_NONE           0           // Instances are independent
+#define     MCH_LINK_AGCO_MAX       1           // AGCo gain decision uses the max level over all instances
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Barrier for a fixed number of threads; reusable
+
+class cMchBarrier
+{
+private:
+    std::mutex              Mtx;
+    std::condition_variable Cv;
+    int                     Count;          // Number of threads that must arrive
+    int                     Waiting;
+    uint32_t                Generation;     // Bumped each time the barrier opens
+
+public:
+    cMchBarrier()
+    {
+        Count = 0;
+        Waiting = 0;
+        Generation = 0;
+    }
+
+    inline void SetCount(int N) { Count = N; }
+
+    void Wait()
+    {
+        std::unique_lock<std::mutex> Lock(Mtx);
+        uint32_t Gen = Generation;
+
+        if (++Waiting == Count)
+        {
+            Waiting = 0;
+            Generation++;
+            Cv.notify_all();
+        }
+        else
+            Cv.wait(Lock, [this, Gen] { return (Gen != Generation); });
+    }
+};
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Module structure (shared by all threads)
+
+struct strMCH
+{
+    int24_t     NumInst;            // Number of instances; 1 runs the single-instance path on the main thread
+    int24_t     LinkMode;           // MCH_LINK_xxx
+    int24_t     ChunkBlocks;        // Blocks in the current chunk
+    bool        Quit;               // Set by main thread to release the instance threads
+
+    void        (*InitInstance)();              // Firmware init, called on each instance thread
+    void        (*ProcessBlock)(int32_t* Buf);  // One block of simulation + firmware, in place on BLOCK_SIZE samples
+
+    int32_t     IoBuf[MCH_MAX_INSTANCES*MCH_CHUNK_BLOCKS*BLOCK_SIZE];               // Interleaved .wav samples, main thread only
+    int32_t     ChunkBuf[MCH_MAX_INSTANCES][MCH_CHUNK_BLOCKS*BLOCK_SIZE];           // Per-instance samples: input to a chunk, then output
+    frac16_t    AgcoLinkLevel[MCH_MAX_INSTANCES][BLOCK_SIZE];                       // Levels published at the AGCo link point
+
+    std::thread Workers[MCH_MAX_INSTANCES];
+    cMchBarrier ChunkBarrier;       // Main thread and all instances; start and end of each chunk
+    cMchBarrier LinkBarrier;        // Instances only; link point within a block
+};
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Function prototypes
+
+void MCH_Init(int24_t NumInst, int24_t LinkMode);
+void MCH_Start(void (*InitInstance)(), void (*ProcessBlock)(int32_t* Buf));
+void MCH_RunChunk(int24_t NumBlocks);
+void MCH_Stop();
+void MCH_LinkAgco();
+
+#endif  // _MCH_H
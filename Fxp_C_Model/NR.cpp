@@ -59,9 +59,43 @@ static const frac24_t NR_NormalizedGainTable[NR_GAIN_TABLE_SIZE] = {
 void NR_Init()
 {
 int24_t bin;
+double Rate;
 
+    NR.BinsPerCall = NR_Params.Persist.BinsPerCall;
+    NR.BinsPerCall = ((NR.BinsPerCall < 1) || (NR.BinsPerCall > WOLA_NUM_BINS)) ? NR_BINS_PER_CALL : NR.BinsPerCall;
     NR.StartBin = 0;
-    NR.EndBin = NR_BINS_PER_CALL-1;
+    NR.EndBin = NR.BinsPerCall-1;
+
+    // TC params are converted for an update of each bin every NR_DEFAULT_SLICES blocks; rescale for the slice
+    // width in use (see rescale_TC()), and the slow noise increment (per update) scales with Rate
+    Rate = (double)((WOLA_NUM_BINS + NR.BinsPerCall - 1)/NR.BinsPerCall)/(double)NR_DEFAULT_SLICES;
+    NR.NoiseFastTC = rescale_TC(NR_Params.Persist.NoiseFastTC, Rate);
+    NR.SpeechTC = rescale_TC(NR_Params.Persist.SpeechTC, Rate);
+    NR.GainSmoothTC = rescale_TC(NR_Params.Persist.GainSmoothTC, Rate);
+    NR.NoiseSlowCoeff = to_frac16(NR_Params.Persist.NoiseSlowCoeff*Rate);
+
+    NR.NoiseTracker = (NR_Params.Persist.NoiseTracker == NR_TRACK_MIN_STAT) ? NR_TRACK_MIN_STAT : NR_TRACK_SLOW_RISE;
+    NR.MinStatWindow = (int24_t)((double)NR_Params.Persist.MinStatWindow/Rate);
+    NR.MinStatWindow = minint(maxint(NR.MinStatWindow, 1), NR_MINSTAT_MAX_WINDOW);
+    NR.MinStatBias = NR_Params.Persist.MinStatBias;
+    NR.MinStatOps = 0;
+    NR.MinStatUpdates = 0;
+
+    // Deque rings, only for the minimum statistics tracker
+    NR_Close();
+    if (NR.NoiseTracker == NR_TRACK_MIN_STAT)
+    {
+        for (NR.MinStatRingSize = 1; NR.MinStatRingSize < NR.MinStatWindow; NR.MinStatRingSize <<= 1)
+            ;
+        NR.MinStatVal = (frac16_t*)malloc((size_t)WOLA_NUM_BINS*NR.MinStatRingSize*sizeof(frac16_t));
+        NR.MinStatTime = (uint32_t*)malloc((size_t)WOLA_NUM_BINS*NR.MinStatRingSize*sizeof(uint32_t));
+        if ((NR.MinStatVal == NULL) || (NR.MinStatTime == NULL))
+        {
+            printf("\nERROR! Could not allocate the NR minimum statistics deques; using the slow-rise tracker...\n\n");
+            NR_Close();
+            NR.NoiseTracker = NR_TRACK_SLOW_RISE;
+        }
+    }
 
     for (bin = 0; bin < WOLA_NUM_BINS; bin++)
     {
@@ -70,6 +104,124 @@ int24_t bin;
         NR.SpeechEst[bin] = NR_INITIAL_SPEECH_ESTIMATE;
         NR.SNREst[bin] = NR.SpeechEst[bin] - NR.NoiseSlowEst[bin];
         NR.BinGainLog2[bin] = to_frac16(0);
+        NR.MinStatHead[bin] = 0;
+        NR.MinStatCount[bin] = 0;
+        NR.BinUpdates[bin] = 0;
+    }
+}
+
+
+// Gain table index from the SNR: the SNR with 16 fractional bits as an integer, shifted down by
+// NR_GAIN_INDEX_SHIFT. Same index as upper_accum_to_i24(shr(SNR, 13)), without the pow() calls.
+#define     NR_GAIN_INDEX_SHIFT         6
+
+static inline int24_t NR_GainIndex(frac16_t Snr)
+{
+int24_t Idx = (int24_t)ldexp(Snr, 16) >> NR_GAIN_INDEX_SHIFT;
+
+    return minint(maxint(Idx, 0), NR_GAIN_TABLE_SIZE-1);
+}
+
+
+// Free the minimum statistics deques; call at the end of the simulation
+void NR_Close()
+{
+    free(NR.MinStatVal);
+    free(NR.MinStatTime);
+    NR.MinStatVal = NULL;
+    NR.MinStatTime = NULL;
+}
+
+
+// Minimum of Val over the last NR.MinStatWindow updates of this bin, including this one
+static frac16_t NR_MinStatUpdate(int24_t bin, frac16_t Val)
+{
+const int24_t Mask = NR.MinStatRingSize-1;
+frac16_t* DqVal = &NR.MinStatVal[bin*NR.MinStatRingSize];
+uint32_t* DqTime = &NR.MinStatTime[bin*NR.MinStatRingSize];
+uint32_t Now = NR.BinUpdates[bin]++;
+int24_t Head = NR.MinStatHead[bin];
+int24_t Count = NR.MinStatCount[bin];
+int24_t Ops = 1;
+
+    // Drop the front once it is out of the window, before the push, so the deque holds at most the window.
+    // One entry per update, so at most one expires
+    if ((Count > 0) && ((Now - DqTime[Head]) >= (uint32_t)NR.MinStatWindow))
+    {
+        Head = (Head + 1) & Mask;
+        Count--;
+        Ops++;
+    }
+
+    // Drop entries from the back that can no longer be the minimum, then push
+    while ((Count > 0) && (DqVal[(Head + Count - 1) & Mask] >= Val))
+    {
+        Count--;
+        Ops++;
+    }
+    DqVal[(Head + Count) & Mask] = Val;
+    DqTime[(Head + Count) & Mask] = Now;
+    Count++;
+
+    NR.MinStatHead[bin] = Head;
+    NR.MinStatCount[bin] = Count;
+    NR.MinStatOps += Ops;
+    NR.MinStatUpdates++;
+    return DqVal[Head];
+}
+
+
+// Update bins First..Last. Each step is a straight pass over the slice, the table index is integer
+// shifts and the table read is a gather, so the passes vectorize for any slice width.
+static void NR_UpdateBins(int24_t First, int24_t Last)
+{
+int24_t GainTableIndex[WOLA_NUM_BINS];
+frac16_t GainTarget;
+frac16_t Diff;
+int24_t bin;
+
+    for (bin = First; bin <= Last; bin++)
+    {
+    // NoiseFastEst = NoiseFastTC*BinPower + (1-NoiseFastTC)*NoiseFastEst = NoiseFastTC*(BinPower - NoiseFastEst) + NoiseFastEst
+    // Doing smoothing in log2 domain
+        Diff = SYS.BinEnergyLog2[bin] - NR.NoiseFastEst[bin];
+        NR.NoiseFastEst[bin] = mul_rnd16(NR.NoiseFastTC, Diff) + NR.NoiseFastEst[bin];
+
+    // SpeechEst = SpeechTC*BinPower + (1-SpeechTC)*SpeechEst = SpeechTC*(BinPower - SpeechEst) + SpeechEst
+        Diff = SYS.BinEnergyLog2[bin] - NR.SpeechEst[bin];
+        NR.SpeechEst[bin] = mul_rnd16(NR.SpeechTC, Diff) + NR.SpeechEst[bin];
+    }
+
+    if (NR.NoiseTracker == NR_TRACK_MIN_STAT)
+    {
+    // NoiseEst = min(FastEst over the window) + bias; the minimum of a smoothed noise level sits below its mean
+        for (bin = First; bin <= Last; bin++)
+            NR.NoiseSlowEst[bin] = NR_MinStatUpdate(bin, NR.NoiseFastEst[bin]) + NR.MinStatBias;
+    }
+    else
+    {
+    // SlowEst: in linear = (1+NoiseSlowCoeff)*SlowEst = SlowEst + NoiseSlowCoeff*SlowEst
+    // in log2:  log2(1+NoiseSlowCoeff) + log2(SlowEst); so just convert NoiseSlowCoeff to log2 domain and add
+    // SlowEst = NoiseEst = min(FastEst, SlowEst)
+        for (bin = First; bin <= Last; bin++)
+            NR.NoiseSlowEst[bin] = min16(NR.NoiseFastEst[bin], NR.NoiseSlowCoeff + NR.NoiseSlowEst[bin]);
+    }
+
+    for (bin = First; bin <= Last; bin++)
+    {
+        NR.NoiseSlowEst[bin] = max16(NR.NoiseSlowEst[bin], NR_MIN_NOISE_ESTIMATE);  // Don't let noise est go too low
+
+    //  SNR = log2(SpeechEst) - log2(NoiseEst);
+        NR.SNREst[bin] = NR.SpeechEst[bin] - NR.NoiseSlowEst[bin];
+        GainTableIndex[bin] = NR_GainIndex(NR.SNREst[bin]);
+    }
+
+    // Gain table output is normalized on [-1.0, 0]; multiply this by the max reduction to get gain, then
+    // smooth the gain (in log2 domain)
+    for (bin = First; bin <= Last; bin++)
+    {
+        GainTarget = mul_rnd16(NR_NormalizedGainTable[GainTableIndex[bin]], NR_Params.Profile.MaxReduction[bin]);
+        NR.BinGainLog2[bin] = mul_rnd16(NR.GainSmoothTC, GainTarget - NR.BinGainLog2[bin]) + NR.BinGainLog2[bin];     // Single-pole smoothing filter to update gain
     }
 }
 
@@ -85,64 +237,23 @@ void NR_Main()
 TODO: Work out interpolation between table gains if entries are log2 domain, or other mapping between them
 */
 int24_t bin;
-frac16_t Diff;
-accum_t Acc;
-int24_t GainTableIndex;
-frac24_t GainScaleTableOut;
-frac16_t GainTarget;
-frac16_t GainDiff;
 
     if (NR_Params.Profile.Enable)
     {
-        for (bin = NR.StartBin; bin <= NR.EndBin; bin++)
-        {
-        // NoiseFastEst = NoiseFastTC*BinPower + (1-NoiseFastTC)*NoiseFastEst = NoiseFastTC*(BinPower - NoiseFastEst) + NoiseFastEst
-        // Doing smoothing in log2 domain
-            Diff = SYS.BinEnergyLog2[bin] - NR.NoiseFastEst[bin];
-            NR.NoiseFastEst[bin] = mul_rnd16(NR_Params.Persist.NoiseFastTC, Diff) + NR.NoiseFastEst[bin];
-
-        // SlowEst: in linear = (1+NoiseSlowCoeff)*SlowEst = SlowEst + NoiseSlowCoeff*SlowEst
-        // in log2:  log2(1+NoiseSlowCoeff) + log2(SlowEst); so just convert NoiseSlowCoeff to log2 domain and add
-            NR.NoiseSlowEst[bin] = NR_Params.Persist.NoiseSlowCoeff + NR.NoiseSlowEst[bin];
+        SYS_DemandBinEnergyLog2(NR.StartBin, NR.EndBin);     // Only this slice of log2 energies is read
 
-        // SlowEst = NoiseEst = min(FastEst, SlowEst)
-            NR.NoiseSlowEst[bin] = min16(NR.NoiseFastEst[bin], NR.NoiseSlowEst[bin]);
-            NR.NoiseSlowEst[bin] = max16(NR.NoiseSlowEst[bin], NR_MIN_NOISE_ESTIMATE);  // Don't let noise est go too low
+        NR_UpdateBins(NR.StartBin, NR.EndBin);
 
-        // SpeechEst = SpeechTC*BinPower + (1-SpeechTC)*SpeechEst = SpeechTC*(BinPower - SpeechEst) + SpeechEst
-            Diff = SYS.BinEnergyLog2[bin] - NR.SpeechEst[bin];
-            NR.SpeechEst[bin] = mul_rnd16(NR_Params.Persist.SpeechTC, Diff) + NR.SpeechEst[bin];
-
-        //  SNR = log2(SpeechEst) - log2(NoiseEst);
-
-            NR.SNREst[bin] = NR.SpeechEst[bin] - NR.NoiseSlowEst[bin];
-
-        // Use SNR*8 (keep 3 fractional bits) as gain LUT input index.  Gain table output is 
-        // normalized on [-1.0, 0]; multiply this by the max reduction to get gain
-            Acc = NR.SNREst[bin];
-            GainTableIndex = upper_accum_to_i24(shr(Acc, 13));    // Remove 13 fractional bits, keep 3
-            GainTableIndex = maxint(GainTableIndex, 0);
-            GainTableIndex = minint(GainTableIndex,(NR_GAIN_TABLE_SIZE-1));
-            GainScaleTableOut = NR_NormalizedGainTable[GainTableIndex];
-            GainTarget = mul_rnd16(GainScaleTableOut, NR_Params.Profile.MaxReduction[bin]);      // Scale normalized table by max gain reduction
-
-        // Smooth the gain (in log2 domain)
-            GainDiff = GainTarget - NR.BinGainLog2[bin];
-            NR.BinGainLog2[bin] = mul_rnd16(NR_Params.Persist.GainSmoothTC, GainDiff) + NR.BinGainLog2[bin];     // Single-pole smoothing filter to update gain
-
-
-        } // for bin
-
-    // Set up next set of bins
+    // Set up next set of bins; the last slice is short if BinsPerCall does not divide WOLA_NUM_BINS
         NR.StartBin = NR.EndBin+1;
         if (NR.StartBin >= WOLA_NUM_BINS)
             NR.StartBin = 0;
-        NR.EndBin = NR.StartBin + (NR_BINS_PER_CALL - 1);
-        NR.EndBin = (NR.EndBin > WOLA_NUM_BINS) ? WOLA_NUM_BINS : NR.EndBin;
+        NR.EndBin = NR.StartBin + (NR.BinsPerCall - 1);
+        NR.EndBin = (NR.EndBin > (WOLA_NUM_BINS-1)) ? (WOLA_NUM_BINS-1) : NR.EndBin;
     }
     else
     {
         for (bin = 0; bin < WOLA_NUM_BINS; bin++)
             NR.BinGainLog2[bin] = to_frac16(0);
     }
-}
\ No newline at end of file
+}
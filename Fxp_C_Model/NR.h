@@ -23,6 +23,18 @@
 #define     NR_GAIN_TABLE_SIZE          32
 
 #define     NR_BINS_PER_CALL            (WOLA_NUM_BINS>>2)      // 8 Make WOLA_NUM_BINS a multiple of this value
+#define     NR_DEFAULT_SLICES           (WOLA_NUM_BINS/NR_BINS_PER_CALL)    // Update rate the TC params are converted for
+
+// Noise floor estimators (NR_Params.Persist.NoiseTracker)
+#define     NR_TRACK_SLOW_RISE          0       // Rise by NoiseSlowCoeff per update, snap down to the fast estimate
+#define     NR_TRACK_MIN_STAT           1       // Sliding-window minimum of the fast estimate, plus bias
+
+// Minimum statistics keeps, per bin, a monotonic deque of (value, update count) over the window: values
+// increase from front to back, so the front is the window minimum. Each update pushes once and pops at
+// most what it pushed over time, so it is O(1) amortized; the deque never holds more than the window.
+// The rings are allocated by NR_Init() only for NR_TRACK_MIN_STAT, sized to the window rounded up to a
+// power of 2 (ring index mask)
+#define     NR_MINSTAT_MAX_WINDOW       1024    // Bin updates; 1.37 s at the default slicing
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // Module structure
@@ -31,12 +43,30 @@ struct strNR
 {
     int24_t     StartBin;
     int24_t     EndBin;
+    int24_t     BinsPerCall;                    // Slice width; WOLA_NUM_BINS updates every bin every block
+    frac24_t    NoiseFastTC;                    // Persist params rescaled to the slice update rate
+    frac16_t    NoiseSlowCoeff;
+    frac24_t    SpeechTC;
+    frac24_t    GainSmoothTC;
+    int24_t     NoiseTracker;                   // NR_TRACK_xxx
+    int24_t     MinStatWindow;                  // Bin updates, rescaled to the slice update rate
+    int24_t     MinStatRingSize;                // Entries per bin; power of 2, at least MinStatWindow
+    frac16_t    MinStatBias;
+    uint32_t    MinStatOps;                     // Deque pushes + pops, for cost reporting
+    uint32_t    MinStatUpdates;
     frac16_t    NoiseSlowEst[WOLA_NUM_BINS];    // This is also the overall noise estimate
     frac16_t    NoiseFastEst[WOLA_NUM_BINS];
     frac16_t    SpeechEst[WOLA_NUM_BINS];
     frac16_t    SNREst[WOLA_NUM_BINS];
     frac16_t    BinGainLog2[WOLA_NUM_BINS];
 
+    // Minimum statistics deques; one ring of MinStatRingSize per bin, NULL unless NR_TRACK_MIN_STAT
+    frac16_t*   MinStatVal;
+    uint32_t*   MinStatTime;
+    int24_t     MinStatHead[WOLA_NUM_BINS];     // Front of deque
+    int24_t     MinStatCount[WOLA_NUM_BINS];
+    uint32_t    BinUpdates[WOLA_NUM_BINS];      // Update count; time stamp for the deque
+
 };
 
 
@@ -45,6 +75,7 @@ struct strNR
 
 void NR_Init();
 void NR_Main();
+void NR_Close();
 
 #endif      // _NR_H
 
@@ -0,0 +1,119 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// Processing pipeline (stage registry and schedule) for fixed-point C code
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include "Common.h"
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Stage enable checks
+
+static bool PIPE_NrEnabled()        { return (NR_Params.Profile.Enable != 0); }
+static bool PIPE_WdrcEnabled()      { return (WDRC_Params.Profile.Enable != 0); }
+static bool PIPE_FbcEnabled()       { return (FBC_Params.Profile.Enable != 0); }
+static bool PIPE_FreqShEnabled()    { return (FBC_Params.Profile.Enable != 0) && (FBC.FreqShiftEnable != 0); }
+static bool PIPE_AgcoLinkEnabled()  { return (MCH.NumInst > 1) && (MCH.LinkMode == MCH_LINK_AGCO_MAX); }
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Stage registry
+// Listed in per-block execution order. To add a module's processing function, add it here
+// with the signals it reads and writes; the schedule is derived from this table.
+// NOTE: A disabled stage must leave its outputs at their init values (unity gain, zero
+// signal), since downstream stages still read them.
+
+static const strPipeStage PIPE_Registry[] =
+{
+//    Name                          Process                         IsEnabled           Consumes                                                    Produces
+    { "SYS_FENG_ApplyInputGain",    SYS_FENG_ApplyInputGain,        NULL,               0,                                                          PIPE_SIG_FWD_ANA_IN },
+    { "SYS_HEAR_WolaFwdAnalysis",   SYS_HEAR_WolaFwdAnalysis,       NULL,               PIPE_SIG_FWD_ANA_IN,                                        PIPE_SIG_FWD_ANA },
+    { "SYS_HEAR_WolaRevAnalysis",   SYS_HEAR_WolaRevAnalysis,       NULL,               PIPE_SIG_OUT_BUF,                                           PIPE_SIG_REV_ANA },
+    { "NR_Main",                    NR_Main,                        PIPE_NrEnabled,     PIPE_SIG_ERROR,                                             PIPE_SIG_NR_GAIN },
+    { "FBC_HEAR_Levels",            FBC_HEAR_Levels,                PIPE_FbcEnabled,    PIPE_SIG_FWD_ANA | PIPE_SIG_REV_ANA | PIPE_SIG_ERROR,       PIPE_SIG_FBC_LEVELS },
+    { "FBC_HEAR_DoFiltering",       FBC_HEAR_DoFiltering,           PIPE_FbcEnabled,    PIPE_SIG_REV_ANA | PIPE_SIG_FBC_COEFFS,                     PIPE_SIG_FBC_FILT },
+    { "SYS_HEAR_ErrorSubAndEnergy", SYS_HEAR_ErrorSubAndEnergy,     NULL,               PIPE_SIG_FWD_ANA | PIPE_SIG_FBC_FILT,                       PIPE_SIG_ERROR },
+    { "WDRC_Main",                  WDRC_Main,                      PIPE_WdrcEnabled,   PIPE_SIG_ERROR,                                             PIPE_SIG_WDRC_GAIN },
+    { "FBC_FilterAdaptation",       FBC_FilterAdaptation,           PIPE_FbcEnabled,    PIPE_SIG_ERROR | PIPE_SIG_REV_ANA | PIPE_SIG_FBC_LEVELS | PIPE_SIG_NR_GAIN | PIPE_SIG_WDRC_GAIN | PIPE_SIG_OUT_BUF,
+                                                                                                                                                    PIPE_SIG_FBC_COEFFS | PIPE_SIG_FBC_GAIN_LIM },
+    { "SYS_HEAR_ApplySubbandGain",  SYS_HEAR_ApplySubbandGain,      NULL,               PIPE_SIG_ERROR | PIPE_SIG_NR_GAIN | PIPE_SIG_WDRC_GAIN | PIPE_SIG_FBC_GAIN_LIM,
+                                                                                                                                                    PIPE_SIG_SYN_BUF },
+    { "FBC_DoFreqShift",            FBC_DoFreqShift,                PIPE_FreqShEnabled, PIPE_SIG_SYN_BUF,                                           PIPE_SIG_SYN_BUF },
+    { "SYS_HEAR_WolaFwdSynthesis",  SYS_HEAR_WolaFwdSynthesis,      NULL,               PIPE_SIG_SYN_BUF,                                           PIPE_SIG_SYN_OUT },
+    { "SYS_FENG_AgcoLevel",         SYS_FENG_AgcoLevel,             NULL,               PIPE_SIG_SYN_OUT,                                           PIPE_SIG_AGCO_LEVEL },
+    { "MCH_LinkAgco",               MCH_LinkAgco,                   PIPE_AgcoLinkEnabled, PIPE_SIG_AGCO_LEVEL,                                      PIPE_SIG_AGCO_LEVEL },
+    { "SYS_FENG_AgcoGain",          SYS_FENG_AgcoGain,              NULL,               PIPE_SIG_SYN_OUT | PIPE_SIG_AGCO_LEVEL,                     PIPE_SIG_OUT_BUF },
+};
+
+#define     PIPE_NUM_REGISTERED     ((int24_t)(sizeof(PIPE_Registry)/sizeof(PIPE_Registry[0])))
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Functions
+
+// Build the per-block schedule. Call AFTER all module inits, since stage enables can
+// depend on values set there (e.g. FBC.FreqShiftEnable).
+void PIPE_Init()
+{
+int24_t s;
+bool Keep[PIPE_NUM_REGISTERED];
+bool Enabled;
+uint32_t PrevNeeded;
+
+    for (s = 0; s < PIPE_NUM_REGISTERED; s++)
+        Keep[s] = false;
+
+    // Walk back from the output, pulling in whatever an enabled, needed stage consumes. Repeat until
+    // nothing changes; some signals are produced late in the block and consumed early in the next one
+    PIPE.Needed = PIPE_SIG_OUT_BUF;
+    do
+    {
+        PrevNeeded = PIPE.Needed;
+        for (s = PIPE_NUM_REGISTERED-1; s >= 0; s--)
+        {
+            Enabled = (PIPE_Registry[s].IsEnabled == NULL) || PIPE_Registry[s].IsEnabled();
+            if (Enabled && (PIPE_Registry[s].Produces & PIPE.Needed))
+            {
+                Keep[s] = true;
+                PIPE.Needed |= PIPE_Registry[s].Consumes;
+            }
+        }
+    } while (PIPE.Needed != PrevNeeded);
+
+    // Schedule kept stages in registry order
+    PIPE.NumStages = 0;
+    for (s = 0; s < PIPE_NUM_REGISTERED; s++)
+    {
+        if (Keep[s])
+        {
+            PIPE.Schedule[PIPE.NumStages] = PIPE_Registry[s].Process;
+            PIPE.StageIdx[PIPE.NumStages] = s;
+            PIPE.NumStages++;
+        }
+    }
+}
+
+
+// Run one block through the scheduled stages
+void PIPE_Run()
+{
+int24_t s;
+
+    for (s = 0; s < PIPE.NumStages; s++)
+        PIPE.Schedule[s]();
+}
+
+
+void PIPE_PrintSchedule()
+{
+int24_t s;
+
+    printf("Processing schedule (%d of %d stages):\n", PIPE.NumStages, PIPE_NUM_REGISTERED);
+    for (s = 0; s < PIPE.NumStages; s++)
+        printf("    %s\n", PIPE_Registry[PIPE.StageIdx[s]].Name);
+}
@@ -0,0 +1,71 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// Processing pipeline (stage registry and schedule) header file for fixed-point C code
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#ifndef _PIPE_H
+#define _PIPE_H
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Defines
+
+// Signals passed between stages. Each stage lists what it consumes and produces; the
+// schedule is built backwards from the output so a stage only runs if it is enabled
+// AND something downstream needs its result.
+#define     PIPE_SIG_FWD_ANA_IN     (1u << 0)       // SYS.FwdAnaIn
+#define     PIPE_SIG_FWD_ANA        (1u << 1)       // SYS.FwdAnaBuf, SYS.MicEnergy
+#define     PIPE_SIG_REV_ANA        (1u << 2)       // SYS.RevAnaBuf, SYS.RevEnergy
+#define     PIPE_SIG_FBC_LEVELS     (1u << 3)       // FBC.ASmoothed, FBC.ESmoothed, FBC.BESmoothed
+#define     PIPE_SIG_FBC_FILT       (1u << 4)       // FBC.FiltSig
+#define     PIPE_SIG_FBC_COEFFS     (1u << 5)       // FBC.Coeffs (used by filtering in the following block)
+#define     PIPE_SIG_ERROR          (1u << 6)       // SYS.Error, SYS.BinEnergy, SYS.BinEnergyLog2
+#define     PIPE_SIG_NR_GAIN        (1u << 7)       // NR.BinGainLog2
+#define     PIPE_SIG_WDRC_GAIN      (1u << 8)       // WDRC.BinGainLog2
+#define     PIPE_SIG_FBC_GAIN_LIM   (1u << 9)       // FBC.GainLimLog2
+#define     PIPE_SIG_SYN_BUF        (1u << 10)      // SYS.FwdSynBuf
+#define     PIPE_SIG_SYN_OUT        (1u << 11)      // SYS.FwdSynOut
+#define     PIPE_SIG_OUT_BUF        (1u << 12)      // SYS.OutBuf; the final product of every block
+#define     PIPE_SIG_AGCO_LEVEL     (1u << 13)      // SYS.AgcoLevelBuf
+
+#define     PIPE_MAX_STAGES         16
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Stage registry entry
+
+struct strPipeStage
+{
+    const char*     Name;               // For debug printout of the schedule
+    void            (*Process)();       // Processing function called once per block
+    bool            (*IsEnabled)();     // NULL if the stage only depends on being needed
+    uint32_t        Consumes;           // PIPE_SIG_xxx bits read by the stage
+    uint32_t        Produces;           // PIPE_SIG_xxx bits written by the stage
+};
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Module structure
+
+struct strPIPE
+{
+    void        (*Schedule[PIPE_MAX_STAGES])();     // Per-block call list, in registry order
+    int24_t     StageIdx[PIPE_MAX_STAGES];          // Registry index of each scheduled stage, for debug
+    int24_t     NumStages;
+    uint32_t    Needed;                             // Signals required by the scheduled stages
+};
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Function prototypes
+
+void PIPE_Init();
+void PIPE_Run();
+void PIPE_PrintSchedule();
+
+#endif  // _PIPE_H
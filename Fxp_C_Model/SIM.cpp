@@ -11,6 +11,15 @@
 
 #include "Common.h"
 
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
 //++++++++++++++++++++++++++++++++++++++++++++++++++
 // Command line parsing; port of Linux getopt() function
 // Code from https://stackoverflow.com/questions/10404448/getopt-h-compiling-linux-c-code-in-windows
@@ -83,15 +92,148 @@ const char *oli;                        /* option letter list index */
 } // getopt
 
 
+// A block count for -W or -F: blocks, or seconds with an 's' suffix
+static bool SIM_ParseBlocks(const char** Str, uint32_t* Block)
+{
+char* End;
+double Val = strtod(*Str, &End);
+
+    if ((End == *Str) || (Val < 0.0))
+        return false;
+    if (*End == 's')
+    {
+        Val *= (double)SUBBAND_SAMPLE_RATE;
+        End++;
+    }
+    *Block = (uint32_t)Val;
+    *Str = End;
+    return true;
+}
+
+
+// -W <start>:<stop>; traces blocks start to stop-1. Either end may be left out
+static bool SIM_ParseWindow(const char* Arg)
+{
+const char* p = Arg;
+
+    SIM.TraceStart = 0;
+    SIM.TraceStop = SIM_TRACE_END;
+    if ((*p != ':') && !SIM_ParseBlocks(&p, &SIM.TraceStart))
+        return false;
+    if (*p++ != ':')
+        return false;
+    if ((*p != '\0') && !SIM_ParseBlocks(&p, &SIM.TraceStop))
+        return false;
+    return ((*p == '\0') && (SIM.TraceStop > SIM.TraceStart));
+}
+
+
+// -F <blocks>[:<triggers>]; trigger names comma separated, all if left out
+static bool SIM_ParseFlight(const char* Arg)
+{
+const char* p = Arg;
+size_t Len;
+int24_t k;
+
+    if (!SIM_ParseBlocks(&p, &SIM.FlightBlocks) || (SIM.FlightBlocks == 0))
+        return false;
+    if (*p == '\0')
+    {
+        SIM.FlightTriggers = FREC_TRIG_ALL;
+        return true;
+    }
+    if (*p++ != ':')
+        return false;
+
+    SIM.FlightTriggers = 0;
+    while (*p != '\0')
+    {
+        Len = strcspn(p, ",");
+        for (k = 0; k < FREC_NUM_TRIGGERS; k++)
+            if ((strlen(FREC_TriggerNames[k]) == Len) && (strncmp(p, FREC_TriggerNames[k], Len) == 0))
+                break;
+        if (k == FREC_NUM_TRIGGERS)
+            return false;
+        SIM.FlightTriggers |= (1u << k);
+        p += (p[Len] == ',') ? Len+1 : Len;
+    }
+    return (SIM.FlightTriggers != 0);
+}
+
+
+// -B <bins>; comma-separated bins and ranges, e.g. 0-7,12
+static bool SIM_ParseBins(const char* Arg)
+{
+bool Sel[WOLA_NUM_BINS];
+const char* p = Arg;
+char* End;
+long Lo, Hi, b;
+
+    for (b = 0; b < WOLA_NUM_BINS; b++)
+        Sel[b] = false;
+
+    while (1)
+    {
+        Lo = strtol(p, &End, 10);
+        if (End == p)
+            return false;
+        p = End;
+        Hi = Lo;
+        if (*p == '-')
+        {
+            p++;
+            Hi = strtol(p, &End, 10);
+            if (End == p)
+                return false;
+            p = End;
+        }
+        if ((Lo < 0) || (Hi < Lo) || (Hi >= WOLA_NUM_BINS))
+            return false;
+        for (b = Lo; b <= Hi; b++)
+            Sel[b] = true;
+
+        if (*p == '\0')
+            break;
+        if (*p++ != ',')
+            return false;
+    }
+
+    SIM.NumTraceBins = 0;
+    for (b = 0; b < WOLA_NUM_BINS; b++)
+        if (Sel[b])
+            SIM.TraceBins[SIM.NumTraceBins++] = (int24_t)b;
+    return true;
+}
+
+
 int8_t parse_command_line(int argc, char * const argv[])
 {
-char ValidOptions[] = "s:r:f:h";     // List of valid option switches.  The ':' after a character means it has must have an argument after it
+char ValidOptions[] = "s:r:g:f:p:t:T:W:D:B:F:A:lbwh";     // List of valid option switches.  The ':' after a character means it has must have an argument after it
 int option;
 int8_t ExitVal = 0;
+int24_t b;
+char* End;
+long Num;
 
     SIM.InfileName = NULL;
+    GEN.Type = GEN_TYPE_NONE;
     SIM.ResultPath = NULL;
     SIM.FBSimFile = NULL;
+    SIM.FB_Engine = FB_ENGINE_AUTO;
+    SIM.AgcoLink = false;
+    SIM.Bench = false;
+    SIM.WdrcChar = false;
+    SIM.TraceMode = TRACE_MODE_ASYNC_WAIT;
+    SIM.FlightBlocks = 0;
+    SIM.FlightTriggers = FREC_TRIG_ALL;
+    SIM.TraceSelect = NULL;
+    SIM.StatSelect = NULL;
+    SIM.TraceStart = 0;
+    SIM.TraceStop = SIM_TRACE_END;
+    SIM.TraceDecim = 1;
+    SIM.NumTraceBins = WOLA_NUM_BINS;
+    for (b = 0; b < WOLA_NUM_BINS; b++)
+        SIM.TraceBins[b] = b;
 
     option = 0;
     while ((option != -1) && (!ExitVal))
@@ -101,9 +243,24 @@ int8_t ExitVal = 0;
         {
             case 'h':
                 printf ("Command line options for %s:", argv[0]);
-                printf ("-s <source file name and path>         REQUIRED\n");
+                printf ("-s <source file name and path>         REQUIRED, UNLESS -g\n");
                 printf ("-r <results output directory>          REQUIRED\n");
-                printf ("-f <Feedback sim file name and path>   FOR USE WITH FBC SIM - LEAVE OFF FOR NO FB SIM\n");
+                printf ("-g <type>[,<key>=<value>...]           GENERATE THE INPUT INSTEAD OF -s: tone, white, pink, sweep, impulse. KEYS: f, f2 (Hz), level (dBFS),\n");
+                printf ("                                       dur, period, seg (s), seed, levels (dBFS, / SEPARATED, seg EACH) (E.G. pink,levels=-60/-25,seg=2,dur=60)\n");
+                printf ("-f <Feedback sim file name and path>   FOR USE WITH FBC SIM - LEAVE OFF FOR NO FB SIM; OR A SCENARIO FILE OF PATH CHANGES (SEE SIM.h)\n");
+                printf ("-p <engine>                            FB SIM: 0 DIRECT FIRs, 1 PARTITIONED FFT; DEFAULT DIRECT UP TO %d TAPS, ELSE PARTITIONED\n", FB_SIM_TAPS);
+                printf ("-t <trace mode>                        PER-BLOCK .npy FILES: 0 WRITE INLINE, 1 WRITER THREAD (DEFAULT), 2 WRITER THREAD, DROP BLOCKS IF BEHIND\n");
+                printf ("-T <signals>                           TRACE ONLY THESE: FILE NAMES WITHOUT .npy OR MODULE PREFIXES, COMMA SEPARATED (E.G. NR_SnrEst,WDRC); none FOR NO TRACES\n");
+                printf ("-W <start>:<stop>                      TRACE BLOCKS start TO stop-1; s SUFFIX FOR SECONDS (E.G. 2.5s:3s); EITHER END MAY BE LEFT OUT\n");
+                printf ("-D <n>                                 TRACE EVERY n-TH BLOCK OF THE WINDOW\n");
+                printf ("-B <bins>                              TRACE ONLY THESE BINS OF PER-BIN SIGNALS (E.G. 0-7,12)\n");
+                printf ("-F <blocks>[:<triggers>]               FLIGHT RECORDER: KEEP THE LAST blocks (s SUFFIX FOR SECONDS) OF THE -T SIGNALS; WRITE THEM\n");
+                printf ("                                       ON A TRIGGER: sat,gainlim,jump,howl (DEFAULT ALL). NO PER-BLOCK FILES; SEE FREC_Events.csv\n");
+                printf ("-A <signals>                           SUMMARY STATISTICS OF THESE (AS FOR -T) OVER THE TRACED BLOCKS: MEAN, STD, MIN, MAX, HISTOGRAM\n");
+                printf ("                                       PER COLUMN; WRITES STAT_Report.csv. USE -T none FOR NO PER-BLOCK FILES\n");
+                printf ("-l                                     LINK AGCO ACROSS CHANNELS OF A MULTI-CHANNEL SOURCE FILE\n");
+                printf ("-b                                     FBC BENCHMARK: SCORE FBC AGAINST THE FB SIM (NEEDS -f); WRITES FBC_Bench.csv, NO PER-BLOCK FBC FILES\n");
+                printf ("-w                                     WDRC CHARACTERIZATION: I/O CURVES, ATTACK AND RELEASE FROM DIRECT LEVEL DRIVE; WRITES WDRC_Char.csv, -s NOT USED\n");
                 printf ("-h                                     THIS HELP MENU\n");
                 printf ("\nNow exiting...\n\n");
                 ExitVal = 1;
@@ -111,12 +268,81 @@ int8_t ExitVal = 0;
             case 's':
                 SIM.InfileName = optarg;      // Point to input file name string
                 break;
+            case 'g':
+                if (!GEN_Parse(optarg))
+                {
+                    printf ("\nInvalid input generator -g %s; use -h for help. Now exiting...\n\n", optarg);
+                    ExitVal = 2;
+                }
+                break;
             case 'r':
                 SIM.ResultPath = optarg;
                 break;
             case 'f':
                 SIM.FBSimFile = optarg;
                 break;
+            case 'p':
+                Num = strtol(optarg, &End, 10);
+                SIM.FB_Engine = (int24_t)Num;
+                if ((End == optarg) || (*End != '\0') || ((Num != FB_ENGINE_DIRECT) && (Num != FB_ENGINE_PART)))
+                {
+                    printf ("\nInvalid FB sim engine -p %s; use -h for help. Now exiting...\n\n", optarg);
+                    ExitVal = 2;
+                }
+                break;
+            case 't':
+                SIM.TraceMode = (int24_t)strtol(optarg, &End, 10);
+                if ((End == optarg) || (*End != '\0') || (SIM.TraceMode < 0) || (SIM.TraceMode >= TRACE_NUM_MODES))
+                {
+                    printf ("\nInvalid trace mode -t %s; use -h for help. Now exiting...\n\n", optarg);
+                    ExitVal = 2;
+                }
+                break;
+            case 'T':
+                SIM.TraceSelect = optarg;
+                break;
+            case 'W':
+                if (!SIM_ParseWindow(optarg))
+                {
+                    printf ("\nInvalid trace window -W %s; use -h for help. Now exiting...\n\n", optarg);
+                    ExitVal = 2;
+                }
+                break;
+            case 'D':
+                Num = strtol(optarg, &End, 10);
+                SIM.TraceDecim = (uint32_t)Num;
+                if ((End == optarg) || (*End != '\0') || (Num < 1) || (Num > INT32_MAX))
+                {
+                    printf ("\nInvalid trace decimation -D %s; use -h for help. Now exiting...\n\n", optarg);
+                    ExitVal = 2;
+                }
+                break;
+            case 'B':
+                if (!SIM_ParseBins(optarg))
+                {
+                    printf ("\nInvalid trace bins -B %s; bins are 0 to %d. Use -h for help. Now exiting...\n\n", optarg, WOLA_NUM_BINS-1);
+                    ExitVal = 2;
+                }
+                break;
+            case 'F':
+                if (!SIM_ParseFlight(optarg))
+                {
+                    printf ("\nInvalid flight recorder setting -F %s; use -h for help. Now exiting...\n\n", optarg);
+                    ExitVal = 2;
+                }
+                break;
+            case 'A':
+                SIM.StatSelect = optarg;
+                break;
+            case 'l':
+                SIM.AgcoLink = true;
+                break;
+            case 'b':
+                SIM.Bench = true;
+                break;
+            case 'w':
+                SIM.WdrcChar = true;
+                break;
             case '?':
                 printf ("\nErroneous Command Line Argument; use -h for help. Now exiting...\n\n");
                 ExitVal = 2;
@@ -130,30 +356,353 @@ int8_t ExitVal = 0;
 //++++++++++++++++++++++++++++++++++++++++++++++++++
 // Audio processing simulation functions
 
+// In-place radix-2 FFT of FB_PART_N points for the partitioned engine, as R2FFTdif / R2FFTdit in WOLA.cpp with
+// a twiddle table. Forward: decimation in frequency, natural order in, bit-reversed out. Inverse: decimation in
+// time, bit-reversed in, natural order out, scaled by 1/FB_PART_N. No reordering is needed between them.
+static void SIM_PartFFT(double* Re, double* Im, bool Inv)
+{
+int24_t Stage, Grp, Bfly;
+int24_t Q, L, M;
+int24_t A, B;
+double Wr, Wi, Tr, Ti;
+double Scale = (Inv) ? 0.5 : 1.0;
+
+    L = (Inv) ? (FB_PART_N >> 1) : 1;
+    M = (Inv) ? 1 : (FB_PART_N >> 1);
+    for (Stage = 0; Stage < FB_PART_N_LOG2; Stage++)
+    {
+        for (Grp = 0, Q = 0; Grp < M; Grp++, Q += L)
+        {
+            Wr = SIM.FB_TwR[Q];
+            Wi = (Inv) ? -SIM.FB_TwI[Q] : SIM.FB_TwI[Q];
+            for (Bfly = 0, A = Grp; Bfly < L; Bfly++, A += (M << 1))
+            {
+                B = A + M;
+                if (Inv)
+                {
+                    Tr = Re[B]*Wr - Im[B]*Wi;
+                    Ti = Re[B]*Wi + Im[B]*Wr;
+                    Re[B] = (Re[A] - Tr)*Scale;
+                    Im[B] = (Im[A] - Ti)*Scale;
+                    Re[A] = (Re[A] + Tr)*Scale;
+                    Im[A] = (Im[A] + Ti)*Scale;
+                }
+                else
+                {
+                    Tr = Re[A] - Re[B];
+                    Ti = Im[A] - Im[B];
+                    Re[A] += Re[B];
+                    Im[A] += Im[B];
+                    Re[B] = Tr*Wr - Ti*Wi;
+                    Im[B] = Ti*Wr + Tr*Wi;
+                }
+            }
+        }
+        L = (Inv) ? (L >> 1) : (L << 1);
+        M = (Inv) ? (M << 1) : (M >> 1);
+    }
+}
+
+
+// Spectra of the FIR1 and FIR2 partitions, each zero-padded to FB_PART_N
+static void SIM_FB_PartSpectra()
+{
+int24_t p, n, tap;
+
+    for (p = 0; p < SIM.FB_Parts; p++)
+    {
+        for (n = 0; n < FB_PART_N; n++)
+        {
+            tap = p*BLOCK_SIZE + n;
+            SIM.FB_PartR[p*FB_PART_N + n] = ((n < BLOCK_SIZE) && (tap < SIM.FB_Taps)) ? SIM.FB_FIR1[tap] : 0.0;
+            SIM.FB_PartI[p*FB_PART_N + n] = ((n < BLOCK_SIZE) && (tap < SIM.FB_Taps)) ? SIM.FB_FIR2[tap] : 0.0;
+        }
+        SIM_PartFFT(&SIM.FB_PartR[p*FB_PART_N], &SIM.FB_PartI[p*FB_PART_N], false);
+    }
+}
+
+
+// FIR spectra and an empty delay line. False if the memory could not be allocated.
+static bool SIM_FB_PartInit()
+{
+int24_t n;
+size_t Size;
+
+    SIM.FB_Parts = (SIM.FB_Taps + BLOCK_SIZE - 1)/BLOCK_SIZE;
+    Size = (size_t)SIM.FB_Parts*FB_PART_N;
+    SIM.FB_PartMem = (double*)malloc(4*Size*sizeof(double));
+    if (SIM.FB_PartMem == NULL)
+        return false;
+    SIM.FB_FdlR = SIM.FB_PartMem;
+    SIM.FB_FdlI = SIM.FB_FdlR + Size;
+    SIM.FB_PartR = SIM.FB_FdlI + Size;
+    SIM.FB_PartI = SIM.FB_PartR + Size;
+
+    for (n = 0; n < FB_PART_N/2; n++)
+    {
+        SIM.FB_TwR[n] = cos(2.0*M_PI*(double)n/(double)FB_PART_N);
+        SIM.FB_TwI[n] = -sin(2.0*M_PI*(double)n/(double)FB_PART_N);
+    }
+
+    SIM_FB_PartSpectra();
+
+    for (n = 0; n < (int24_t)Size; n++)
+    {
+        SIM.FB_FdlR[n] = 0.0;
+        SIM.FB_FdlI[n] = 0.0;
+    }
+    for (n = 0; n < FB_PART_N; n++)
+        SIM.FB_Frame[n] = 0.0;
+    SIM.FB_FdlIdx = 0;
+    return true;
+}
+
+
+// Map a file read-only; the view stays valid after the file is closed. NULL if it cannot be mapped.
+static const void* SIM_MapFile(const char* Name, size_t* Bytes)
+{
+void* View = NULL;
+#ifdef _WIN32
+HANDLE File, Map;
+LARGE_INTEGER Size;
+
+    File = CreateFileA(Name, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (File == INVALID_HANDLE_VALUE)
+        return NULL;
+    if (GetFileSizeEx(File, &Size) && (Size.QuadPart > 0))
+    {
+        Map = CreateFileMappingA(File, NULL, PAGE_READONLY, 0, 0, NULL);
+        if (Map != NULL)
+        {
+            View = MapViewOfFile(Map, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(Map);
+        }
+        *Bytes = (size_t)Size.QuadPart;
+    }
+    CloseHandle(File);
+#else
+FILE* fp = NULL;
+struct stat St;
+
+    fopen_s(&fp, Name, "rb");
+    if (fp == NULL)
+        return NULL;
+    if ((fstat(fileno(fp), &St) == 0) && (St.st_size > 0))
+    {
+        View = mmap(NULL, (size_t)St.st_size, PROT_READ, MAP_PRIVATE, fileno(fp), 0);
+        View = (View == MAP_FAILED) ? NULL : View;
+        *Bytes = (size_t)St.st_size;
+    }
+    fclose(fp);
+#endif
+    return View;
+}
+
+
+static void SIM_UnmapFile(const void* View, size_t Bytes)
+{
+    if (View == NULL)
+        return;
+#ifdef _WIN32
+    UnmapViewOfFile(View);
+#else
+    munmap((void*)View, Bytes);
+#endif
+}
+
+
+// Shape of a .npy file of doubles in C order, as numpy.save writes it, and where its data starts
+static bool SIM_NpyShape2(const uint8_t* File, size_t Bytes, int24_t* Rows, int24_t* Cols, size_t* DataOffset)
+{
+char Hdr[256];
+const char* Shape;
+size_t HdrLen;
+
+    if ((Bytes < 12) || (memcmp(File, "\x93NUMPY", 6) != 0))
+        return false;
+    if (File[6] == 1)
+    {
+        HdrLen = (size_t)File[8] | ((size_t)File[9] << 8);
+        *DataOffset = 10 + HdrLen;
+    }
+    else
+    {
+        HdrLen = (size_t)File[8] | ((size_t)File[9] << 8) | ((size_t)File[10] << 16) | ((size_t)File[11] << 24);
+        *DataOffset = 12 + HdrLen;
+    }
+    if ((*DataOffset > Bytes) || (HdrLen >= sizeof(Hdr)))
+        return false;
+    memcpy(Hdr, &File[*DataOffset - HdrLen], HdrLen);
+    Hdr[HdrLen] = '\0';
+
+    if ((strstr(Hdr, "'<f8'") == NULL) || (strstr(Hdr, "'fortran_order': False") == NULL) || ((Shape = strstr(Hdr, "'shape': (")) == NULL))
+        return false;
+    if ((sscanf_s(Shape + 10, "%d, %d", Rows, Cols) != 2) || (*Rows < 1) || (*Cols < 1))
+        return false;
+    return (*DataOffset + (size_t)(*Rows)*(size_t)(*Cols)*sizeof(double) <= Bytes);
+}
+
+
+// Map the bank and read the path changes of a scenario file; the SCENARIO line has been read
+static bool SIM_FB_LoadScenario(FILE* fbf, const char* BankName)
+{
+char Name[512];
+const char* Dir;
+size_t Offset;
+int24_t Paths, Taps;
+double Sec, Fade;
+int Path;
+uint32_t PrevStart = 0, PrevEnd = 0, MinStart;
+strFbEvent* Ev;
+
+    // The bank is relative to the scenario file unless it has a full path
+    Dir = strrchr(SIM.FBSimFile, '/');
+    Dir = ((strrchr(SIM.FBSimFile, '\\') != NULL) && ((Dir == NULL) || (strrchr(SIM.FBSimFile, '\\') > Dir))) ? strrchr(SIM.FBSimFile, '\\') : Dir;
+    if ((Dir == NULL) || (BankName[0] == '/') || (BankName[0] == '\\') || ((BankName[0] != '\0') && (BankName[1] == ':')))
+        sprintf_s(Name, "%s", BankName);
+    else
+        sprintf_s(Name, "%.*s%s", (int)(Dir - SIM.FBSimFile + 1), SIM.FBSimFile, BankName);
+
+    SIM.FB_BankView = SIM_MapFile(Name, &SIM.FB_BankBytes);
+    if ((SIM.FB_BankView == NULL) || !SIM_NpyShape2((const uint8_t*)SIM.FB_BankView, SIM.FB_BankBytes, &Paths, &Taps, &Offset) || (Taps > FB_SIM_MAX_TAPS))
+    {
+        printf ("\nERROR! FB scenario bank %s must be a .npy file of doubles, shape (paths, 1 to %d taps)...\n", Name, FB_SIM_MAX_TAPS);
+        SIM_UnmapFile(SIM.FB_BankView, SIM.FB_BankBytes);
+        SIM.FB_BankView = NULL;
+        return false;
+    }
+    SIM.FB_Bank = (const double*)((const uint8_t*)SIM.FB_BankView + Offset);
+    SIM.FB_BankPaths = Paths;
+    SIM.FB_Taps = Taps;
+
+    SIM.FB_NumEvents = 0;
+    while (fscanf_s(fbf, "%le %d %le", &Sec, &Path, &Fade) == 3)
+    {
+        if ((SIM.FB_NumEvents == FB_SIM_MAX_EVENTS) || (Sec < 0.0) || (Fade < 0.0) || (Path < FB_SIM_NO_PATH) || (Path >= Paths))
+        {
+            printf ("\nERROR! FB scenario change %d (%g %d %g) is not valid; at most %d changes, paths %d to %d...\n",
+                SIM.FB_NumEvents, Sec, Path, Fade, FB_SIM_MAX_EVENTS, FB_SIM_NO_PATH, Paths - 1);
+            SIM_UnmapFile(SIM.FB_BankView, SIM.FB_BankBytes);
+            SIM.FB_BankView = NULL;
+            SIM.FB_NumEvents = 0;
+            return false;
+        }
+
+        // A change is started at the beginning of its block, which must be after the previous change and its crossfade
+        Ev = &SIM.FB_Events[SIM.FB_NumEvents];
+        Ev->Start = (uint32_t)(Sec*(double)BASEBAND_SAMPLE_RATE);
+        MinStart = (SIM.FB_NumEvents == 0) ? 0 : (((PrevEnd > PrevStart) ? PrevEnd : (PrevStart + 1)) + BLOCK_SIZE - 1)/BLOCK_SIZE*BLOCK_SIZE;
+        if (Ev->Start/BLOCK_SIZE*BLOCK_SIZE < MinStart)
+        {
+            printf("\nWARNING: FB scenario change %d at %.4f s is before the end of the previous change; moved to %.4f s\n\n",
+                SIM.FB_NumEvents, Sec, (double)MinStart/(double)BASEBAND_SAMPLE_RATE);
+            Ev->Start = MinStart;
+        }
+        Ev->Len = Fade*(double)BASEBAND_SAMPLE_RATE;
+        Ev->End = Ev->Start + (uint32_t)Ev->Len;
+        Ev->Path = Path;
+        PrevStart = Ev->Start;
+        PrevEnd = Ev->End;
+        SIM.FB_NumEvents++;
+    }
+    return true;
+}
+
+
+static void SIM_FB_SetPath(double* Fir, int24_t Path)
+{
+int24_t i;
+
+    for (i = 0; i < SIM.FB_Taps; i++)
+        Fir[i] = (Path == FB_SIM_NO_PATH) ? 0.0 : SIM.FB_Bank[(size_t)Path*SIM.FB_Taps + i];
+}
+
+
+// Start the next path change of a scenario, at the beginning of the block it starts in: fade from the current path
+// in FIR1 to the new one in FIR2. The previous crossfade has ended, so the feedback does not change until the new one starts.
+static void SIM_FB_NextEvent()
+{
+const strFbEvent* Ev = &SIM.FB_Events[SIM.FB_NextEvent++];
+
+    SIM_FB_SetPath(SIM.FB_FIR1, SIM.FB_CurPath);
+    SIM_FB_SetPath(SIM.FB_FIR2, Ev->Path);
+    SIM.FB_CurPath = Ev->Path;
+    SIM.TransitionStart = Ev->Start;
+    SIM.TransitionEnd = Ev->End;
+    SIM.TransitionLen = Ev->Len;
+    if (SIM.FB_Engine == FB_ENGINE_PART)
+        SIM_FB_PartSpectra();
+}
+
+
 static void SIM_FB_Init()
 {
 unsigned i;
 FILE* fbf = NULL;
 double fileval;
+int Taps;
+int Len;
+char BankName[256];
 
-    for (i = 0; i < FB_SIM_TAPS; i++)
+    for (i = 0; i < FB_SIM_MAX_TAPS; i++)
         SIM.OutBufDelay[i] = to_frac24(0);
 
     // Set up simulation counters
     SIM.CurOpIdx = 0;
     SIM.CurSample = 0;
+    SIM.FB_Taps = FB_SIM_TAPS;
+    SIM.FB_PartMem = NULL;
+    SIM.TransitionLen = FB_SIM_TRNSTION_SMPLS_DBL;
+    SIM.FB_BankView = NULL;
+    SIM.FB_NumEvents = 0;
+    SIM.FB_NextEvent = 0;
+    SIM.FB_CurPath = FB_SIM_NO_PATH;
 
     if (FBC_Params.Profile.Enable)
     {
         // Open feedback sim file for read
         if (SIM.FBSimFile != NULL)
             fopen_s(&fbf, SIM.FBSimFile, "r");
-        if (fbf == NULL)    // If can't read, default to no sim (FIRs set to 0.0s)
+
+        // Optional first line "FIRLEN <taps>" for other than FB_SIM_TAPS taps per FIR
+        if ((fbf != NULL) && (fscanf_s(fbf, " FIRLEN %d", &Taps) == 1))
+        {
+            if ((Taps < 1) || (Taps > FB_SIM_MAX_TAPS))
+            {
+                printf ("\nERROR! FB sim file FIRLEN %d must be 1 to %d...\n", Taps, FB_SIM_MAX_TAPS);
+                fclose(fbf);
+                fbf = NULL;
+            }
+            else
+                SIM.FB_Taps = Taps;
+        }
+
+        // Or a scenario; see SIM.h. The bank name is the rest of the line.
+        Len = -1;
+        if (fbf != NULL)
+            fscanf_s(fbf, " SCENARIO %n", &Len);
+        if ((Len >= 0) && (fgets(BankName, sizeof(BankName), fbf) != NULL))
         {
-            printf ("\nERROR! Could not open FB sim file %s for read...\n\n", SIM.FBSimFile);
+            BankName[strcspn(BankName, "\r\n")] = '\0';
+            if (!SIM_FB_LoadScenario(fbf, BankName))
+            {
+                fclose(fbf);
+                fbf = NULL;
+            }
+        }
+
+        if ((fbf == NULL) || (SIM.FB_BankView != NULL))    // If can't read, default to no sim (FIRs set to 0.0s); a scenario starts with no feedback
+        {
+            if (fbf == NULL)
+                printf ("\nERROR! Could not open FB sim file %s for read...\n\n", SIM.FBSimFile);
+            else
+            {
+                fclose(fbf);
+                printf("FB scenario: %d paths of %d taps, %d changes\n", SIM.FB_BankPaths, SIM.FB_Taps, SIM.FB_NumEvents);
+            }
             SIM.TransitionStart = (uint32_t)(-1);   // Set so never encountered
             SIM.TransitionEnd = (uint32_t)(-1);
-            for (i = 0; i < FB_SIM_TAPS; i++)
+            for (i = 0; i < (unsigned)SIM.FB_Taps; i++)
             {
                 SIM.FB_FIR1[i] = to_frac24(0.0);
                 SIM.FB_FIR2[i] = to_frac24(0.0);
@@ -161,95 +710,262 @@ double fileval;
         }
         else
         {
-        // FORMAT (all double values): transition start in seconds, FIR1 values, FIR2 values
+        // FORMAT (all double values after any FIRLEN line): transition start in seconds, FIR1 values, FIR2 values
         // Scale the FIR coefficients with any desired gain
             fscanf_s(fbf, "%le", &fileval);
             SIM.TransitionStart = (uint32_t)(fileval*(double)BASEBAND_SAMPLE_RATE);
             SIM.TransitionEnd = SIM.TransitionStart + (uint32_t)FB_SIM_TRNSTION_SMPLS_DBL;
-            for (i = 0; i < FB_SIM_TAPS; i++)
+            for (i = 0; i < (unsigned)SIM.FB_Taps; i++)
             {
                 fscanf_s(fbf, "%le", &(SIM.FB_FIR1[i]));
             }
-            for (i = 0; i < FB_SIM_TAPS; i++)
+            for (i = 0; i < (unsigned)SIM.FB_Taps; i++)
             {
                 fscanf_s(fbf, "%le", &(SIM.FB_FIR2[i]));
             }
             fclose(fbf);
         }
     }
-}
 
+    // Delay line for the direct engine: the next power of two at or above the FIR length
+    for (i = FB_SIM_TAPS; i < (unsigned)SIM.FB_Taps; i <<= 1)
+        ;
+    SIM.OutBufMask = (uint16_t)(i - 1);
 
-// Call this setup after parameters have been initialized
-// Enable file output for modules that are enabled.
+    if (SIM.FB_Engine == FB_ENGINE_AUTO)
+        SIM.FB_Engine = (SIM.FB_Taps > FB_SIM_TAPS) ? FB_ENGINE_PART : FB_ENGINE_DIRECT;
+    if ((SIM.FB_Engine == FB_ENGINE_PART) && !SIM_FB_PartInit())
+    {
+        printf("\nERROR! Could not allocate the partitioned FB sim engine; using direct FIRs...\n\n");
+        SIM.FB_Engine = FB_ENGINE_DIRECT;
+    }
+    if ((SIM.FB_Taps != FB_SIM_TAPS) || (SIM.FB_Engine != FB_ENGINE_DIRECT))
+        printf("FB sim: %d taps, %s\n", SIM.FB_Taps, (SIM.FB_Engine == FB_ENGINE_PART) ? "partitioned FFT engine" : "direct FIRs");
+}
 
-static void SIM_OutputFileSetup()
+
+// FBC keeps its coefficients by coefficient, then bin; trace them by bin, as FBC_Coeffs always has been
+static void* SIM_FbcCoeffsByBin()
 {
-unsigned fidx;
-char fname[256];
+static thread_local Complex24 ByBin[WOLA_NUM_BINS*FBC_COEFFS_PER_BIN];
+unsigned bin, cf;
 
-// Open SYS files (always)
-    
-    sprintf_s(SIM.OutFileName, "%s/%s", SIM.ResultPath, "Fixp_Out.wav");    // Create name of output .wav file; opened later
+    for (bin = 0; bin < WOLA_NUM_BINS; bin++)
+        for (cf = 0; cf < FBC_COEFFS_PER_BIN; cf++)
+            ByBin[bin*FBC_COEFFS_PER_BIN + cf] = FBC.Coeffs[cf][bin];
+    return ByBin;
+}
 
-    sprintf_s(fname, "%s/%s", SIM.ResultPath, "SYS_Error.csv");         fopen_s(&SIM.SysFiles[SysError], fname, "w");     // if returns NULL, let error occur when trying to write to the file
-    sprintf_s(fname, "%s/%s", SIM.ResultPath, "SYS_FwdGainLog2.csv");   fopen_s(&SIM.SysFiles[SysFwdGainL2], fname, "w");
-    sprintf_s(fname, "%s/%s", SIM.ResultPath, "SYS_AgcoGainLog2.csv");  fopen_s(&SIM.SysFiles[SysAgcoGainL2], fname, "w");
-    sprintf_s(fname, "%s/%s", SIM.ResultPath, "SYS_FwdAnaBuf.csv");     fopen_s(&SIM.SysFiles[SysFwdAnaBuf], fname, "w");
-    sprintf_s(fname, "%s/%s", SIM.ResultPath, "SYS_FwdSynOut.csv");     fopen_s(&SIM.SysFiles[SysFwdSynOut], fname, "w");
 
-// Open WDRC files
-    if (WDRC_Params.Profile.Enable)
-    {
-        sprintf_s(fname, "%s/%s", SIM.ResultPath, "WDRC_LevelLog2.csv");      fopen_s(&SIM.WdrcFiles[WdrcLevelL2], fname, "w");
-        sprintf_s(fname, "%s/%s", SIM.ResultPath, "WDRC_BinGainLog2.csv");    fopen_s(&SIM.WdrcFiles[WdrcBinGainL2], fname, "w");
-    }
-    else
-    {
-        for (fidx = 0; fidx < NUM_WDRC_FILES; fidx++)
-            SIM.WdrcFiles[fidx] = NULL;
-    }
+// Signal registry; in enTraceSignals order. Signals not traced by default are named with -T
+static const strSimSignal SIM_Signals[NUM_TRACE_SIGNALS] =
+{
+    { "SYS_Error",          SIM_MOD_SYS,  TRACE_TYPE_C16, WOLA_NUM_BINS,      1, true,  -32,   0, []() -> void* { return SYS.Error; } },
+    { "SYS_FwdGainLog2",    SIM_MOD_SYS,  TRACE_TYPE_F8,  WOLA_NUM_BINS,      1, true,  -16,  16, []() -> void* { return SYS.FwdGainLog2; } },
+    { "SYS_AgcoGainLog2",   SIM_MOD_SYS,  TRACE_TYPE_F8,  1,                  0, true,   -8,   8, []() -> void* { return &SYS.AgcoGainLog2; } },
+    { "SYS_FwdAnaBuf",      SIM_MOD_SYS,  TRACE_TYPE_C16, WOLA_NUM_BINS,      1, true,  -32,   0, []() -> void* { return SYS.FwdAnaBuf; } },
+    { "SYS_FwdSynOut",      SIM_MOD_SYS,  TRACE_TYPE_F8,  BLOCK_SIZE,         0, true,   -1,   1, []() -> void* { return SYS.FwdSynOut; } },
+    { "SYS_OutBuf",         SIM_MOD_SYS,  TRACE_TYPE_F8,  BLOCK_SIZE,         0, false,  -1,   1, []() -> void* { return SYS.OutBuf; } },
+    { "WDRC_LevelLog2",     SIM_MOD_WDRC, TRACE_TYPE_F8,  WDRC_NUM_CHANNELS,  0, true,  -32,   0, []() -> void* { return WDRC.LevelLog2; } },
+    { "WDRC_BinGainLog2",   SIM_MOD_WDRC, TRACE_TYPE_F8,  WOLA_NUM_BINS,      1, true,  -32,  16, []() -> void* { return WDRC.BinGainLog2; } },
+    { "FBC_Coeffs",         SIM_MOD_FBC,  TRACE_TYPE_C16, WOLA_NUM_BINS*FBC_COEFFS_PER_BIN, FBC_COEFFS_PER_BIN, true,  -48,   0, SIM_FbcCoeffsByBin },
+    { "FBC_CoefMag",        SIM_MOD_FBC,  TRACE_TYPE_F8,  WOLA_NUM_BINS,      1, true,  -48,   0, []() -> void* { return FBC.CoefMag; } },
+    { "FBC_AdaptShift",     SIM_MOD_FBC,  TRACE_TYPE_I4,  WOLA_NUM_BINS,      1, true,  -24,   8, []() -> void* { return FBC.AdaptShift; } },
+    { "FBC_Sinusoid",       SIM_MOD_FBC,  TRACE_TYPE_C16, 1,                  0, true,   -4,   4, []() -> void* { return FBC.Sinusoid; } },
+    { "FBC_ESmoothed",      SIM_MOD_FBC,  TRACE_TYPE_F8,  WOLA_NUM_BINS,      1, true,    0,   1, []() -> void* { return FBC.ESmoothed; } },
+    { "FBC_BESmoothed",     SIM_MOD_FBC,  TRACE_TYPE_F8,  WOLA_NUM_BINS,      1, true,    0,   1, []() -> void* { return FBC.BESmoothed; } },
+    { "FBC_GainLimLog2",    SIM_MOD_FBC,  TRACE_TYPE_F8,  WOLA_NUM_BINS,      1, false,  -8,  40, []() -> void* { return FBC.GainLimLog2; } },
+    { "NR_NoiseEst",        SIM_MOD_NR,   TRACE_TYPE_F8,  WOLA_NUM_BINS,      1, true,  -32,   0, []() -> void* { return NR.NoiseSlowEst; } },
+    { "NR_FastNoiseEst",    SIM_MOD_NR,   TRACE_TYPE_F8,  WOLA_NUM_BINS,      1, true,  -32,   0, []() -> void* { return NR.NoiseFastEst; } },
+    { "NR_SpeechEst",       SIM_MOD_NR,   TRACE_TYPE_F8,  WOLA_NUM_BINS,      1, true,  -32,   0, []() -> void* { return NR.SpeechEst; } },
+    { "NR_SnrEst",          SIM_MOD_NR,   TRACE_TYPE_F8,  WOLA_NUM_BINS,      1, true,  -16,  16, []() -> void* { return NR.SNREst; } },
+    { "NR_BinGainLog2",     SIM_MOD_NR,   TRACE_TYPE_F8,  WOLA_NUM_BINS,      1, true,   -8,   0, []() -> void* { return NR.BinGainLog2; } },
+};
 
-// Open FBC files
-    if (FBC_Params.Profile.Enable)
+
+static bool SIM_ModuleTraced(int24_t Module)
+{
+    switch (Module)
     {
-        sprintf_s(fname, "%s/%s", SIM.ResultPath, "FBC_Coeffs.csv");        fopen_s(&SIM.FbcFiles[FbcCoeffs], fname, "w");
-        sprintf_s(fname, "%s/%s", SIM.ResultPath, "FBC_CoefMag.csv");       fopen_s(&SIM.FbcFiles[FbcCoefMag], fname, "w");
-        sprintf_s(fname, "%s/%s", SIM.ResultPath, "FBC_AdaptShift.csv");    fopen_s(&SIM.FbcFiles[FbcAdaptShift], fname, "w");
-        sprintf_s(fname, "%s/%s", SIM.ResultPath, "FBC_Sinusoid.csv");      fopen_s(&SIM.FbcFiles[FbcSinusoid], fname, "w");
-        sprintf_s(fname, "%s/%s", SIM.ResultPath, "FBC_ESmoothed.csv");     fopen_s(&SIM.FbcFiles[FbcESmooth], fname, "w");
-        sprintf_s(fname, "%s/%s", SIM.ResultPath, "FBC_BESmoothed.csv");    fopen_s(&SIM.FbcFiles[FbcBeSmooth], fname, "w");        
+        case SIM_MOD_WDRC:  return (WDRC_Params.Profile.Enable != 0);
+        case SIM_MOD_FBC:   return (FBC_Params.Profile.Enable != 0) && !SIM.Bench;
+        case SIM_MOD_NR:    return (NR_Params.Profile.Enable != 0);
+        default:            return true;
     }
-    else
+}
+
+
+// True if the Len characters at Tok are the signal's name or its module prefix
+static bool SIM_TokenMatches(const char* Tok, size_t Len, const char* Name)
+{
+    return (strncmp(Tok, Name, Len) == 0) && ((Name[Len] == '\0') || (Name[Len] == '_'));
+}
+
+
+// Select is a -T or -A list (Opt); "none" selects nothing
+static bool SIM_SignalSelected(const strSimSignal* Sig, const char* Select, char Opt, bool Warn)
+{
+const char* Tok;
+size_t Len;
+int24_t k;
+bool Found;
+bool Selected = false;
+
+    for (Tok = Select; *Tok != '\0'; Tok += (Tok[Len] == ',') ? Len+1 : Len)
     {
-        for (fidx = 0; fidx < NUM_FBC_FILES; fidx++)
-            SIM.FbcFiles[fidx] = NULL;
+        Len = strcspn(Tok, ",");
+        if ((Len > 0) && SIM_TokenMatches(Tok, Len, Sig->Name))
+            Selected = true;
+        if (Warn && (Len > 0))
+        {
+            for (k = 0, Found = (Len == 4) && (strncmp(Tok, "none", 4) == 0); k < NUM_TRACE_SIGNALS; k++)
+                Found = Found || SIM_TokenMatches(Tok, Len, SIM_Signals[k].Name);
+            if (!Found)
+                printf("\nWARNING: -%c %.*s is not a traced signal or module; ignored\n\n", Opt, (int)Len, Tok);
+        }
     }
+    return Selected;
+}
+
+
+// Call this setup after parameters have been initialized
+// Open trace files for the selected signals of enabled modules, and list the signals to summarise
 
-// Open NR files
-    if (NR_Params.Profile.Enable)
+static void SIM_OutputFileSetup()
+{
+const strSimSignal* Sig;
+int24_t k;
+
+    SIM_SetOutFileName();
+
+    SIM.NumTraced = 0;
+    SIM.NumStat = 0;
+    for (k = 0; k < NUM_TRACE_SIGNALS; k++)
     {
-        sprintf_s(fname, "%s/%s", SIM.ResultPath, "NR_NoiseEst.csv");     fopen_s(&SIM.NrFiles[NrNoiseEst], fname, "w");
-        sprintf_s(fname, "%s/%s", SIM.ResultPath, "NR_FastNoiseEst.csv"); fopen_s(&SIM.NrFiles[NrFastNoiseEst], fname, "w");
-        sprintf_s(fname, "%s/%s", SIM.ResultPath, "NR_SpeechEst.csv");    fopen_s(&SIM.NrFiles[NrSpeechEst], fname, "w");
-        sprintf_s(fname, "%s/%s", SIM.ResultPath, "NR_SnrEst.csv");       fopen_s(&SIM.NrFiles[NrSNREst], fname, "w");
-        sprintf_s(fname, "%s/%s", SIM.ResultPath, "NR_BinGainLog2.csv");  fopen_s(&SIM.NrFiles[NrBinGainL2], fname, "w");
+        Sig = &SIM_Signals[k];
+        TRACE_Clear(&SIM.Traces[k]);
+        if (!SIM_ModuleTraced(Sig->Module))
+            continue;
+        if ((SIM.TraceSelect == NULL) ? Sig->Default : SIM_SignalSelected(Sig, SIM.TraceSelect, 'T', (k == 0)))
+        {
+            if (SIM.FlightBlocks == 0)      // Else the flight recorder keeps them; see FREC_Init()
+                TRACE_Open(&SIM.Traces[k], Sig->Name, Sig->Type, SIM_SignalWidth(Sig));
+            SIM.TraceList[SIM.NumTraced++] = k;
+        }
+        if ((SIM.StatSelect != NULL) && SIM_SignalSelected(Sig, SIM.StatSelect, 'A', (k == 0)))
+            SIM.StatList[SIM.NumStat++] = k;
     }
+
+// Block index, so rows can be matched up when not every block is traced
+    if ((SIM.NumTraced > 0) && (SIM.FlightBlocks == 0) &&
+        ((SIM.TraceMode == TRACE_MODE_ASYNC_DROP) || (SIM.TraceStart > 0) || (SIM.TraceStop != SIM_TRACE_END) || (SIM.TraceDecim > 1)))
+        TRACE_Open(&SIM.BlockFile, "SIM_BlockIdx", TRACE_TYPE_I4, 1);
     else
+        TRACE_Clear(&SIM.BlockFile);
+
+    SIM.TraceDecimCount = 0;
+
+    if ((SIM.FlightBlocks == 0) && ((SIM.TraceSelect != NULL) || (SIM.BlockFile.fp != NULL) || (SIM.NumTraceBins < WOLA_NUM_BINS)))
     {
-        for (fidx = 0; fidx < NUM_NR_FILES; fidx++)
-            SIM.NrFiles[fidx] = NULL;
+        printf("Tracing %d of %d signals, %d of %d bins, from block %u ", SIM.NumTraced, NUM_TRACE_SIGNALS, SIM.NumTraceBins, WOLA_NUM_BINS, SIM.TraceStart);
+        if (SIM.TraceStop == SIM_TRACE_END)
+            printf("to the end");
+        else
+            printf("to %u", SIM.TraceStop - 1);
+        printf(", every %u\n", SIM.TraceDecim);
     }
 }
 
 
+// Create name of output .wav file; opened later by top level
+void SIM_SetOutFileName()
+{
+    sprintf_s(SIM.OutFileName, "%s/%s", SIM.ResultPath, "Fixp_Out.wav");
+}
+
+
 void SIM_Init()
 {
     // Set up feedback simulation
     SIM_FB_Init();
 
+    BENCH.Enable = SIM.Bench;
+    BENCH_Init();
+
     // Set up the simulation files
     SIM_OutputFileSetup();
+    TRACE_StartLog(SIM.TraceMode);
+    FREC_Init();
+    STAT_Init();
+}
+
+
+// Mixing factor of FIR1 into the feedback signal at a given sample; 1.0 before the transition, 0.0 after
+double SIM_FeedbackMix(uint32_t Sample)
+{
+double S1;
+
+    if (Sample < SIM.TransitionStart)
+        S1 = 1.0;
+    else if ((Sample >= SIM.TransitionStart) && (Sample < SIM.TransitionEnd))
+    {
+        S1 = 1.0 - ((double)(Sample - SIM.TransitionStart)/SIM.TransitionLen);
+        S1 = (S1 < 0.0) ? 0.0 : S1;       // Catch edge case, keep scale positive
+    }
+    else    // After TransitionEnd
+        S1 = 0.0;
+
+    return S1;
+}
+
+
+// Partitioned engine: both paths' feedback for this block. The newest output frame's spectrum goes into the
+// delay line, is multiplied with partition 0, older frames with later partitions, and the sum is transformed back.
+// Overlap-save: the last BLOCK_SIZE samples of the inverse are the output.
+static void SIM_FeedbackPart(const frac24_t* outBuf, double* F1, double* F2)
+{
+double Yr[FB_PART_N], Yi[FB_PART_N];
+const double *Xr, *Xi, *Hr, *Hi;
+int24_t p, n, Slot;
+
+    for (n = 0; n < BLOCK_SIZE; n++)
+    {
+        SIM.FB_Frame[n] = SIM.FB_Frame[n + BLOCK_SIZE];
+        SIM.FB_Frame[n + BLOCK_SIZE] = (double)outBuf[n];
+    }
+
+    SIM.FB_FdlIdx = (SIM.FB_FdlIdx == 0) ? (SIM.FB_Parts - 1) : (SIM.FB_FdlIdx - 1);     // Overwrites the oldest frame
+    for (n = 0; n < FB_PART_N; n++)
+    {
+        SIM.FB_FdlR[SIM.FB_FdlIdx*FB_PART_N + n] = SIM.FB_Frame[n];
+        SIM.FB_FdlI[SIM.FB_FdlIdx*FB_PART_N + n] = 0.0;
+    }
+    SIM_PartFFT(&SIM.FB_FdlR[SIM.FB_FdlIdx*FB_PART_N], &SIM.FB_FdlI[SIM.FB_FdlIdx*FB_PART_N], false);
+
+    for (n = 0; n < FB_PART_N; n++)
+    {
+        Yr[n] = 0.0;
+        Yi[n] = 0.0;
+    }
+    for (p = 0, Slot = SIM.FB_FdlIdx; p < SIM.FB_Parts; p++, Slot = (Slot == SIM.FB_Parts - 1) ? 0 : (Slot + 1))
+    {
+        Xr = &SIM.FB_FdlR[Slot*FB_PART_N];
+        Xi = &SIM.FB_FdlI[Slot*FB_PART_N];
+        Hr = &SIM.FB_PartR[p*FB_PART_N];
+        Hi = &SIM.FB_PartI[p*FB_PART_N];
+        for (n = 0; n < FB_PART_N; n++)
+        {
+            Yr[n] += Xr[n]*Hr[n] - Xi[n]*Hi[n];
+            Yi[n] += Xr[n]*Hi[n] + Xi[n]*Hr[n];
+        }
+    }
+    SIM_PartFFT(Yr, Yi, true);
+
+    for (n = 0; n < BLOCK_SIZE; n++)
+    {
+        F1[n] = Yr[n + BLOCK_SIZE];
+        F2[n] = Yi[n + BLOCK_SIZE];
+    }
 }
 
 
@@ -263,30 +979,36 @@ double F1, F2;      // Use doubles for simulation
 double S1;
 double FBSig;
 double CombinedSig;
+double F1Part[BLOCK_SIZE], F2Part[BLOCK_SIZE];
+
+    if ((SIM.FB_NextEvent < SIM.FB_NumEvents) && (SIM.FB_Events[SIM.FB_NextEvent].Start < SIM.CurSample + BLOCK_SIZE))
+        SIM_FB_NextEvent();
+
+    if (SIM.FB_Engine == FB_ENGINE_PART)
+        SIM_FeedbackPart(outBuf, F1Part, F2Part);
 
     for (sample = 0; sample < BLOCK_SIZE; sample++)
     {
-        F1 = 0.0;
-        F2 = 0.0;
-        SIM.OutBufDelay[SIM.CurOpIdx] = outBuf[sample];    // overwrite oldest with new sample
-        for (tap = 0, k = SIM.CurOpIdx; tap < FB_SIM_TAPS; tap++)
+        if (SIM.FB_Engine == FB_ENGINE_PART)
         {
-            F1 += SIM.FB_FIR1[tap]*(double)SIM.OutBufDelay[k];
-            F2 += SIM.FB_FIR2[tap]*(double)SIM.OutBufDelay[k];
-            k = (k - 1) & FB_SIM_TAPS_MASK;     // go back in time in out buffer delay line
+            F1 = F1Part[sample];
+            F2 = F2Part[sample];
         }
-        SIM.CurOpIdx = (SIM.CurOpIdx+1) & FB_SIM_TAPS_MASK;   // move to next sample in buffer, forward in time
-
-        // Create the mixing factors
-        if (SIM.CurSample < SIM.TransitionStart)
-            S1 = 1.0;
-        else if ((SIM.CurSample >= SIM.TransitionStart) && (SIM.CurSample < SIM.TransitionEnd))
+        else
         {
-            S1 = 1.0 - ((double)(SIM.CurSample - SIM.TransitionStart)/FB_SIM_TRNSTION_SMPLS_DBL);
-            S1 = (S1 < 0.0) ? 0.0 : S1;       // Catch edge case, keep scale positive
+            F1 = 0.0;
+            F2 = 0.0;
+            SIM.OutBufDelay[SIM.CurOpIdx] = outBuf[sample];    // overwrite oldest with new sample
+            for (tap = 0, k = SIM.CurOpIdx; tap < (unsigned)SIM.FB_Taps; tap++)
+            {
+                F1 += SIM.FB_FIR1[tap]*(double)SIM.OutBufDelay[k];
+                F2 += SIM.FB_FIR2[tap]*(double)SIM.OutBufDelay[k];
+                k = (k - 1) & SIM.OutBufMask;     // go back in time in out buffer delay line
+            }
+            SIM.CurOpIdx = (SIM.CurOpIdx+1) & SIM.OutBufMask;   // move to next sample in buffer, forward in time
         }
-        else    // After TransitionEnd
-            S1 = 0.0;
+
+        S1 = SIM_FeedbackMix(SIM.CurSample);
 
         // Combine F1 and F2 into feedback signal using scale factor; saturate; add back into input buffer
 
@@ -300,118 +1022,116 @@ double CombinedSig;
 }
 
 
-// TODO: Update write functions to handle fixed-point types
-void SIM_WriteComplex24 (FILE* fp, Complex24* Cval, unsigned NumVals)
+const strSimSignal* SIM_GetSignal(int24_t Idx)
 {
-unsigned i = 0;     // init to 0 for NumVals = 1 case
-
-    if (fp != NULL)
-    {
-        for (; i < (NumVals-1); i++)
-            fprintf(fp, "%2.12e%+2.12ej, ", Cval[i].Real(), Cval[i].Imag());
-        fprintf(fp, "%2.12e%+2.12ej\n", Cval[i].Real(), Cval[i].Imag());
-    }
+    return &SIM_Signals[Idx];
 }
 
 
-void SIM_Write48 (FILE* fp, frac48_t* Cval, unsigned NumVals)
+// Values per row; per-bin signals keep only the -B bins
+int24_t SIM_SignalWidth(const strSimSignal* Sig)
 {
-unsigned i = 0;     // init to 0 for NumVals = 1 case
-
-    if (fp != NULL)
-    {
-        for (; i < (NumVals-1); i++)
-            fprintf(fp, "%2.12e, ", Cval[i]);
-        fprintf(fp, "%2.12e\n", Cval[i]);
-    }
+    return (Sig->BinStride > 0) ? SIM.NumTraceBins*Sig->BinStride : Sig->Width;
 }
 
 
-void SIM_Write24 (FILE* fp, frac24_t* Cval, unsigned NumVals)
+// Current block's row of a signal in trace file format: -B bins only, complex as real/imag pairs.
+// Points into Buf (TRACE_MAX_ROW_DBL doubles), or at the signal itself if no conversion is needed.
+const void* SIM_SignalRow(const strSimSignal* Sig, double* Buf)
 {
-unsigned i = 0;     // init to 0 for NumVals = 1 case
+void* Data = Sig->Data();
+int24_t Width = SIM_SignalWidth(Sig);
+bool Subset = (Sig->BinStride > 0) && (SIM.NumTraceBins < WOLA_NUM_BINS);
+int24_t* IntBuf = (int24_t*)Buf;
+int24_t n, Src;
 
-    if (fp != NULL)
-    {
-        for (; i < (NumVals-1); i++)
-            fprintf(fp, "%2.12e, ", Cval[i]);
-        fprintf(fp, "%2.12e\n", Cval[i]);
-    }
-}
-
-void SIM_Write16 (FILE* fp, frac16_t* Cval, unsigned NumVals)
-{
-unsigned i = 0;     // init to 0 for NumVals = 1 case
+    if (!Subset && (Sig->Type != TRACE_TYPE_C16))
+        return Data;
 
-    if (fp != NULL)
+    for (n = 0; n < Width; n++)
     {
-        for (; i < (NumVals-1); i++)
-            fprintf(fp, "%2.12e, ", Cval[i]);
-        fprintf(fp, "%2.12e\n", Cval[i]);
+        Src = Subset ? (SIM.TraceBins[n / Sig->BinStride]*Sig->BinStride + (n % Sig->BinStride)) : n;
+        switch (Sig->Type)
+        {
+            case TRACE_TYPE_C16:
+                Buf[2*n] = ((Complex24*)Data)[Src].Real();
+                Buf[2*n + 1] = ((Complex24*)Data)[Src].Imag();
+                break;
+            case TRACE_TYPE_I4:
+                IntBuf[n] = ((int24_t*)Data)[Src];
+                break;
+            default:
+                Buf[n] = ((double*)Data)[Src];
+                break;
+        }
     }
+    return Buf;
 }
 
-void SIM_WriteInt (FILE* fp, int24_t* Cval, unsigned NumVals)
+
+// Trace and summarise the selected signals for this block, if in the window and not decimated away
+void SIM_LogFiles()
 {
-unsigned i = 0;     // init to 0 for NumVals = 1 case
+uint32_t Block = SIM.CurSample/BLOCK_SIZE - 1;     // SIM_Feedback() has counted this block's samples
+int24_t BlockIdx;
+double Row[TRACE_MAX_ROW_DBL];
+int24_t k;
 
-    if (fp != NULL)
+    if (((SIM.NumTraced == 0) && (SIM.NumStat == 0)) || (Block < SIM.TraceStart) || (Block >= SIM.TraceStop))
+        return;
+    if (SIM.TraceDecimCount > 0)
     {
-        for (; i < (NumVals-1); i++)
-            fprintf(fp, "%d, ", Cval[i]);
-        fprintf(fp, "%d\n", Cval[i]);
+        SIM.TraceDecimCount--;
+        return;
     }
+    SIM.TraceDecimCount = SIM.TraceDecim - 1;
 
-}
+    STAT_Update();
+    if ((SIM.NumTraced == 0) || (SIM.FlightBlocks > 0))
+        return;
 
+    TRACE_BeginBlock();
 
-void SIM_LogFiles()
-{
-    SIM_WriteComplex24 (SIM.SysFiles[SysError], SYS.Error, WOLA_NUM_BINS);
-    SIM_Write16 (SIM.SysFiles[SysFwdGainL2], SYS.FwdGainLog2, WOLA_NUM_BINS);
-    SIM_Write16 (SIM.SysFiles[SysAgcoGainL2], &SYS.AgcoGainLog2, 1);
-    SIM_WriteComplex24 (SIM.SysFiles[SysFwdAnaBuf], SYS.FwdAnaBuf, WOLA_NUM_BINS);
-    SIM_Write24 (SIM.SysFiles[SysFwdSynOut], SYS.FwdSynOut, BLOCK_SIZE);
-
-    SIM_Write16 (SIM.WdrcFiles[WdrcLevelL2], WDRC.LevelLog2, WDRC_NUM_CHANNELS);
-    SIM_Write16 (SIM.WdrcFiles[WdrcBinGainL2], WDRC.BinGainLog2, WOLA_NUM_BINS);
-
-    SIM_WriteComplex24 (SIM.FbcFiles[FbcCoeffs], &FBC.Coeffs[0][0], (WOLA_NUM_BINS*FBC_COEFFS_PER_BIN));
-    SIM_Write16 (SIM.FbcFiles[FbcCoefMag], FBC.CoefMag, WOLA_NUM_BINS); 
-    SIM_WriteInt (SIM.FbcFiles[FbcAdaptShift], FBC.AdaptShift, WOLA_NUM_BINS);
-    SIM_Write48 (SIM.FbcFiles[FbcESmooth], FBC.ESmoothed, WOLA_NUM_BINS);
-    SIM_Write48 (SIM.FbcFiles[FbcBeSmooth], FBC.BESmoothed, WOLA_NUM_BINS);
-    SIM_WriteComplex24 (SIM.FbcFiles[FbcSinusoid], FBC.Sinusoid, 1);
-
-    SIM_Write16 (SIM.NrFiles[NrNoiseEst], NR.NoiseSlowEst, WOLA_NUM_BINS);
-    SIM_Write16 (SIM.NrFiles[NrFastNoiseEst], NR.NoiseFastEst, WOLA_NUM_BINS);
-    SIM_Write16 (SIM.NrFiles[NrSpeechEst], NR.SpeechEst, WOLA_NUM_BINS);
-    SIM_Write16 (SIM.NrFiles[NrSNREst], NR.SNREst, WOLA_NUM_BINS);
-    SIM_Write16 (SIM.NrFiles[NrBinGainL2], NR.BinGainLog2, WOLA_NUM_BINS);
+    BlockIdx = (int24_t)Block;
+    TRACE_WriteRow(&SIM.BlockFile, &BlockIdx);
+    for (k = 0; k < SIM.NumTraced; k++)
+        TRACE_WriteRow(&SIM.Traces[SIM.TraceList[k]], SIM_SignalRow(&SIM_Signals[SIM.TraceList[k]], Row));
+
+    TRACE_EndBlock();
 }
 
 
-static void SIM_CloseOutFiles(FILE** FileList, unsigned NumFiles)
+void SIM_CloseSim()
 {
-unsigned fidx;
+int24_t k;
 
-    for (fidx = 0; fidx < NumFiles; fidx++)
-    {
-        if (FileList[fidx] != NULL)
-        {
-            fclose(FileList[fidx]);
-            FileList[fidx] = NULL;
-        }
-    }
-}
+    TRACE_StopLog();
+    for (k = 0; k < NUM_TRACE_SIGNALS; k++)
+        TRACE_Close(&SIM.Traces[k]);
+    TRACE_Close(&SIM.BlockFile);
+    free(SIM.FB_PartMem);
+    SIM.FB_PartMem = NULL;
+    SIM_UnmapFile(SIM.FB_BankView, SIM.FB_BankBytes);
+    SIM.FB_BankView = NULL;
+    FREC_Close();
+    NR_Close();
+    STAT_Report();
 
+    BENCH_Report();
 
-void SIM_CloseSim()
-{
-    SIM_CloseOutFiles(SIM.SysFiles,  NUM_SYS_FILES);
-    SIM_CloseOutFiles(SIM.WdrcFiles, NUM_WDRC_FILES);
-    SIM_CloseOutFiles(SIM.FbcFiles,  NUM_FBC_FILES);
-    SIM_CloseOutFiles(SIM.NrFiles,   NUM_NR_FILES);
+    if ((TRACE.WaitCount > 0) || (TRACE.DroppedBlocks > 0))
+        printf("Trace writer mode %d: %u blocks written, %u dropped, %u waits for the writer; ring peak %u of %u KB\n", TRACE.Mode,
+            TRACE.QueuedBlocks, TRACE.DroppedBlocks, TRACE.WaitCount, TRACE.MaxFill >> 10, TRACE_RING_BYTES >> 10);
+    if (SYS.LowPowerMode != SYS_LOWPWR_OFF)
+        printf("Low-power mode %d: %u quiet blocks\n", SYS.LowPowerMode, SYS.QuietBlockCount);
+    if (FBC_Params.Profile.Enable && (FBC_Params.Profile.AdaptGateMode != FBC_GATE_OFF))
+        printf("FBC adaptation gating mode %d: %u bins gated, %u bin updates\n", FBC_Params.Profile.AdaptGateMode, FBC.GatedCount, FBC.AdaptCount);
+    if (FBC_Params.Profile.Enable && (FBC.Engine != FBC_ENGINE_NLMS))
+        printf("FBC adaptation engine %d: %d multiplies per adapted bin, %.0f per block\n", FBC.Engine, FBC.AdaptOpsPerBin,
+            (SIM.CurSample >= BLOCK_SIZE) ? (double)FBC.AdaptOps/(double)(SIM.CurSample/BLOCK_SIZE) : 0.0);
+    if (NR_Params.Profile.Enable && (NR.NoiseTracker == NR_TRACK_MIN_STAT))
+        printf("NR minimum statistics: window %d updates, %.3f deque ops per bin update\n", NR.MinStatWindow,
+            (NR.MinStatUpdates > 0) ? (double)NR.MinStatOps/(double)NR.MinStatUpdates : 0.0);
 }
 
 
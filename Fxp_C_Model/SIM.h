@@ -27,49 +27,86 @@
 
 // Feedback setup
 #define     FB_SIM_TAPS_LOG2            7
-#define     FB_SIM_TAPS                 (1 << FB_SIM_TAPS_LOG2)     // Guarantee power of two size. NOTE: This needs to account for bulk delay 0s at start of filters
-#define     FB_SIM_TAPS_MASK            (FB_SIM_TAPS - 1)
+#define     FB_SIM_TAPS                 (1 << FB_SIM_TAPS_LOG2)     // FIR length of a FB sim file without a FIRLEN line. NOTE: This needs to account for bulk delay 0s at start of filters
+#define     FB_SIM_MAX_TAPS_LOG2        13
+#define     FB_SIM_MAX_TAPS             (1 << FB_SIM_MAX_TAPS_LOG2)     // Longest FIRLEN; 341 ms
+
+// Feedback sim engines (-p). Both give the same result to double rounding.
+#define     FB_ENGINE_AUTO              -1      // Direct for FB_SIM_TAPS or fewer taps, else partitioned
+#define     FB_ENGINE_DIRECT            0       // FIR1 and FIR2 sample by sample
+#define     FB_ENGINE_PART              1       // Uniformly partitioned overlap-save FFT convolution; one partition per block
+#define     FB_PART_N_LOG2              4
+#define     FB_PART_N                   (1 << FB_PART_N_LOG2)       // 2*BLOCK_SIZE: last block and this block
 
 #define     FB_SIM_TRANSITION_TIME      0.1             // Transition between feedback FIRs, in seconds
 #define     FB_SIM_TRNSTION_SMPLS_DBL   (FB_SIM_TRANSITION_TIME*(double)BASEBAND_SAMPLE_RATE)
 
-// File output enumerations
-enum enSysFiles
+// Scenario: a FB sim file whose first line is "SCENARIO <bank>", then one line per path change,
+// "<start seconds> <path> <crossfade seconds>", in time order. The bank is a .npy file of doubles, shape
+// (paths, taps), relative to the scenario file; it is memory mapped, not read. Path -1 is no feedback, which
+// is also the path before the first change. A change starts no earlier than the block after the previous crossfade.
+#define     FB_SIM_MAX_EVENTS           256
+#define     FB_SIM_NO_PATH              -1
+
+// Traced signals; order of SIM_Signals[] in SIM.cpp. One .npy file each, named as in SIM_Signals[]
+enum enTraceSignals
 {
     SysError = 0,
     SysFwdGainL2,
     SysAgcoGainL2,
     SysFwdAnaBuf,
     SysFwdSynOut,
-    NUM_SYS_FILES
-};
-
-enum enWdrcFiles
-{
-    WdrcLevelL2 = 0,
+    SysOutBuf,
+    WdrcLevelL2,
     WdrcBinGainL2,
-    NUM_WDRC_FILES
-};
-
-enum enFbcFiles
-{
-    FbcCoeffs = 0,
+    FbcCoeffs,
     FbcCoefMag,
     FbcAdaptShift,
     FbcSinusoid,
     FbcESmooth,
     FbcBeSmooth,
-    NUM_FBC_FILES
-};
-
-enum enNrFiles
-{
-    NrNoiseEst = 0,
+    FbcGainLimL2,
+    NrNoiseEst,
     NrFastNoiseEst,
     NrSpeechEst,
     NrSNREst,
     NrBinGainL2,
-    NUM_NR_FILES
+    NUM_TRACE_SIGNALS
+};
+
+// Modules; a signal is traced only if its module is enabled
+#define     SIM_MOD_SYS                 0
+#define     SIM_MOD_WDRC                1
+#define     SIM_MOD_FBC                 2       // Not with -b; the benchmark replaces the per-block FBC files
+#define     SIM_MOD_NR                  3
+
+#define     SIM_TRACE_END               ((uint32_t)(-1))    // Trace window open to the end of the file
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Traced signal description
+
+struct strSimSignal
+{
+    const char* Name;               // File name without .npy
+    int24_t     Module;             // SIM_MOD_xxx
+    int24_t     Type;               // TRACE_TYPE_xxx
+    int24_t     Width;              // Values per block
+    int24_t     BinStride;          // Values per bin if the signal is per bin, for bin subsets (-B); 0 if not
+    bool        Default;            // Traced when -T is not given
+    double      HistLo;             // Summary statistics histogram range (-A); log2 magnitude for complex signals
+    double      HistHi;
+    void*       (*Data)();          // Current block's values
+};
+
+
+// One path change of a scenario
+struct strFbEvent
+{
+    uint32_t    Start;              // Sample the crossfade starts
+    uint32_t    End;
+    double      Len;                // Crossfade samples
+    int24_t     Path;               // Bank path faded to; FB_SIM_NO_PATH for none
 };
 
 
@@ -82,21 +119,65 @@ struct strSIM
     char        OutFileName[256];   // Output .wav file name including path; reserve the space here
     char*       ResultPath;         // Result path where to write simulation results
     char*       FBSimFile;          // Input file including path with feedback sim values (start time in seconds, FIR1 coeffs, FIR2 coeffs)
+    bool        AgcoLink;           // Link AGCo across instances of a multi-channel input file
+    bool        Bench;              // Score FBC against the feedback sim (BENCH module) instead of logging FBC per block
+    bool        WdrcChar;           // Characterize WDRC on its own (BENCH module) instead of processing a .wav file
+    char        FilePrefix[16];     // Prepended to result file names; "chN_" per instance of a multi-channel simulation, else empty
+    int24_t     TraceMode;          // TRACE_MODE_xxx; how the per-block trace files are written
+    uint32_t    FlightBlocks;       // -F: flight recorder depth in blocks; 0 for per-block trace files
+    uint32_t    FlightTriggers;     // -F: FREC_TRIG_xxx bits
 
 // Feedback simulation members
-    double      FB_FIR1[FB_SIM_TAPS];       // Keep these as doubles; put any gain into the filter coefficients
-    double      FB_FIR2[FB_SIM_TAPS];
-    frac24_t    OutBufDelay[FB_SIM_TAPS];
+    double      FB_FIR1[FB_SIM_MAX_TAPS];   // Keep these as doubles; put any gain into the filter coefficients
+    double      FB_FIR2[FB_SIM_MAX_TAPS];
+    int24_t     FB_Taps;        // FIR1 and FIR2 length; FB_SIM_TAPS unless the FB sim file starts with FIRLEN
+    int24_t     FB_Engine;      // -p: FB_ENGINE_xxx
+    frac24_t    OutBufDelay[FB_SIM_MAX_TAPS];
+    uint16_t    OutBufMask;     // Delay line length - 1; the length is a power of two, at least FB_Taps
     uint16_t    CurOpIdx;       // Current output buffer index
     uint32_t    CurSample;      // current simulation sample; limits sim size to 4292967295 samples, which is 178956.97 sec @ 24kHz
     uint32_t    TransitionStart;
     uint32_t    TransitionEnd;
-
-// File output
-    FILE*       SysFiles[NUM_SYS_FILES];
-    FILE*       WdrcFiles[NUM_WDRC_FILES];
-    FILE*       FbcFiles[NUM_FBC_FILES];
-    FILE*       NrFiles[NUM_NR_FILES];
+    double      TransitionLen;  // Samples from TransitionStart to TransitionEnd
+
+// Scenario: FIR1 is the path before the current change, FIR2 the path after it
+    const double*   FB_Bank;    // FB_BankPaths paths of FB_Taps taps, in the mapped bank file
+    int24_t     FB_BankPaths;
+    const void* FB_BankView;    // Mapping of the whole bank file; NULL if no scenario
+    size_t      FB_BankBytes;
+    int24_t     FB_NumEvents;   // 0 if no scenario
+    int24_t     FB_NextEvent;
+    int24_t     FB_CurPath;     // Path after the latest change
+    strFbEvent  FB_Events[FB_SIM_MAX_EVENTS];
+
+// Partitioned engine. Spectra are in the bit-reversed order of the forward FFT; the inverse FFT takes them in that order.
+// FIR1 and FIR2 are one complex filter, FIR1 + j*FIR2, so the real and imaginary outputs are the two paths.
+    int24_t     FB_Parts;       // Partitions of BLOCK_SIZE taps
+    int24_t     FB_FdlIdx;      // Slot of the newest frame in the delay line; partition p uses slot FB_FdlIdx + p
+    double*     FB_PartMem;     // One allocation at init for the four arrays below
+    double*     FB_FdlR;        // Frequency-domain delay line: FB_Parts spectra of output frames
+    double*     FB_FdlI;
+    double*     FB_PartR;       // FB_Parts spectra of FIR partitions
+    double*     FB_PartI;
+    double      FB_Frame[FB_PART_N];    // Output samples, last block then this block
+    double      FB_TwR[FB_PART_N/2];    // Forward FFT twiddles
+    double      FB_TwI[FB_PART_N/2];
+
+// Trace file output (.npy)
+    char*       TraceSelect;        // -T: signal names and module prefixes, comma separated; NULL traces the defaults, "none" nothing
+    uint32_t    TraceStart;         // -W: first and last block traced
+    uint32_t    TraceStop;
+    uint32_t    TraceDecim;         // -D: trace every TraceDecim-th block of the window
+    uint32_t    TraceDecimCount;    // Blocks until the next traced block
+    int24_t     NumTraceBins;       // -B: bins of per-bin signals; WOLA_NUM_BINS if no subset
+    int24_t     TraceBins[WOLA_NUM_BINS];
+    int24_t     NumTraced;          // Signals traced, indices into SIM_Signals[]; only these cost anything per block
+    int24_t     TraceList[NUM_TRACE_SIGNALS];
+    strTrace    Traces[NUM_TRACE_SIGNALS];
+    strTrace    BlockFile;          // Block index of each row; when rows are not one per block (-W, -D, drop mode)
+    char*       StatSelect;         // -A: signals summarised over the traced blocks, as for -T; NULL for none
+    int24_t     NumStat;
+    int24_t     StatList[NUM_TRACE_SIGNALS];
 
 };
 
@@ -109,7 +190,12 @@ char* get_optarg();
 int8_t parse_command_line(int argc, char * const argv[]);
 
 void SIM_Init();
+void SIM_SetOutFileName();
+double SIM_FeedbackMix(uint32_t Sample);
 void SIM_Feedback(frac24_t* inBuf, frac24_t* outBuf);
+const strSimSignal* SIM_GetSignal(int24_t Idx);
+int24_t SIM_SignalWidth(const strSimSignal* Sig);
+const void* SIM_SignalRow(const strSimSignal* Sig, double* Buf);
 void SIM_LogFiles();
 void SIM_CloseSim();
 
@@ -0,0 +1,162 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// Summary statistics (simulation only) for fixed-point C code
+// Keeps running per-column statistics and histograms of the selected signals instead of writing them every block
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include "Common.h"
+
+
+// Call from SIM_Init(), after SIM_OutputFileSetup() has made the signal list
+void STAT_Init()
+{
+const strSimSignal* Sig;
+uint32_t c;
+int24_t k, h;
+
+    STAT.Enable = (SIM.NumStat > 0);
+    STAT.Cols = NULL;
+    STAT.Blocks = 0;
+    if (!STAT.Enable)
+        return;
+
+    STAT.NumSignals = SIM.NumStat;
+    STAT.NumCols = 0;
+    for (k = 0; k < STAT.NumSignals; k++)
+    {
+        Sig = SIM_GetSignal(SIM.StatList[k]);
+        STAT.Signals[k] = Sig;
+        STAT.Width[k] = SIM_SignalWidth(Sig);
+        STAT.ColOffset[k] = STAT.NumCols;
+        STAT.HistScale[k] = (double)STAT_HIST_BINS/(Sig->HistHi - Sig->HistLo);
+        STAT.NumCols += STAT.Width[k];
+    }
+
+    STAT.Cols = (strStatCol*)malloc(STAT.NumCols*sizeof(strStatCol));
+    if (STAT.Cols == NULL)
+    {
+        printf("\nERROR! Could not allocate %u KB for summary statistics; not summarising...\n\n", (uint32_t)((STAT.NumCols*sizeof(strStatCol)) >> 10));
+        STAT.Enable = false;
+        return;
+    }
+    for (c = 0; c < STAT.NumCols; c++)
+    {
+        STAT.Cols[c].Mean = 0.0;
+        STAT.Cols[c].M2 = 0.0;
+        STAT.Cols[c].Min = HUGE_VAL;
+        STAT.Cols[c].Max = -HUGE_VAL;
+        for (h = 0; h < STAT_HIST_BINS + 2; h++)
+            STAT.Cols[c].Hist[h] = 0;
+    }
+
+    printf("Summary statistics: %d signals, %u columns\n", STAT.NumSignals, STAT.NumCols);
+}
+
+
+// Call for every traced block; see SIM_LogFiles()
+void STAT_Update()
+{
+double Row[TRACE_MAX_ROW_DBL];
+const void* Vals;
+const strSimSignal* Sig;
+strStatCol* Col;
+double InvN, x, Delta, Pos;
+int24_t k, n;
+
+    if (!STAT.Enable)
+        return;
+
+    STAT.Blocks++;
+    InvN = 1.0/(double)STAT.Blocks;
+    for (k = 0; k < STAT.NumSignals; k++)
+    {
+        Sig = STAT.Signals[k];
+        Vals = SIM_SignalRow(Sig, Row);
+        Col = &STAT.Cols[STAT.ColOffset[k]];
+        for (n = 0; n < STAT.Width[k]; n++, Col++)
+        {
+            switch (Sig->Type)
+            {
+                case TRACE_TYPE_C16:
+                    x = ((const double*)Vals)[2*n]*((const double*)Vals)[2*n] + ((const double*)Vals)[2*n + 1]*((const double*)Vals)[2*n + 1];
+                    x = (x > 0.0) ? 0.5*log2(x) : STAT_LOG2_FLOOR;
+                    break;
+                case TRACE_TYPE_I4:
+                    x = (double)((const int24_t*)Vals)[n];
+                    break;
+                default:
+                    x = ((const double*)Vals)[n];
+                    break;
+            }
+
+            Delta = x - Col->Mean;
+            Col->Mean += Delta*InvN;
+            Col->M2 += Delta*(x - Col->Mean);
+            Col->Min = (x < Col->Min) ? x : Col->Min;
+            Col->Max = (x > Col->Max) ? x : Col->Max;
+
+            Pos = (x - Sig->HistLo)*STAT.HistScale[k];
+            if (Pos < 0.0)
+                Col->Hist[0]++;
+            else if (Pos >= (double)STAT_HIST_BINS)
+                Col->Hist[STAT_HIST_BINS + 1]++;
+            else
+                Col->Hist[1 + (int24_t)Pos]++;
+        }
+    }
+}
+
+
+// Call from SIM_CloseSim(); one row per column: its bin (-1 if the signal is not per bin) and index within the row
+void STAT_Report()
+{
+const strSimSignal* Sig;
+const strStatCol* Col;
+FILE* fp = NULL;
+char fname[256];
+int24_t k, n, h;
+
+    if (!STAT.Enable)
+        return;
+
+    sprintf_s(fname, "%s/%s%s", SIM.ResultPath, SIM.FilePrefix, "STAT_Report.csv");
+    fopen_s(&fp, fname, "w");
+    if (fp == NULL)
+        printf("\nERROR! Could not open %s for write...\n\n", fname);
+    else
+    {
+        fprintf(fp, "Signal, Column, Bin, Count, Mean, Std, Min, Max, HistLo, HistHi, Under");
+        for (h = 0; h < STAT_HIST_BINS; h++)
+            fprintf(fp, ", H%d", h);
+        fprintf(fp, ", Over\n");
+
+        for (k = 0; k < STAT.NumSignals; k++)
+        {
+            Sig = STAT.Signals[k];
+            for (n = 0; n < STAT.Width[k]; n++)
+            {
+                Col = &STAT.Cols[STAT.ColOffset[k] + n];
+                fprintf(fp, "%s, %d, %d, %u, ", Sig->Name, n, (Sig->BinStride > 0) ? SIM.TraceBins[n / Sig->BinStride] : -1, STAT.Blocks);
+                if (STAT.Blocks > 0)
+                    fprintf(fp, "%.6g, %.6g, %.6g, %.6g", Col->Mean, sqrt(Col->M2/(double)STAT.Blocks), Col->Min, Col->Max);
+                else
+                    fprintf(fp, "0, 0, 0, 0");
+                fprintf(fp, ", %g, %g", Sig->HistLo, Sig->HistHi);
+                for (h = 0; h < STAT_HIST_BINS + 2; h++)
+                    fprintf(fp, ", %u", Col->Hist[h]);
+                fprintf(fp, "\n");
+            }
+        }
+        fclose(fp);
+    }
+
+    printf("Summary statistics: %u blocks of %d signals in %s\n", STAT.Blocks, STAT.NumSignals, fname);
+    free(STAT.Cols);
+    STAT.Cols = NULL;
+}
@@ -0,0 +1,58 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// Summary statistics (simulation only) header file for fixed-point C code
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#ifndef _STAT_H
+#define _STAT_H
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Defines
+
+// With -A, every column of the selected signals (-B bins only) is summarised over the traced blocks (-W, -D):
+// count, mean and variance (Welford), min, max and a histogram over the signal's HistLo to HistHi in SIM_Signals[].
+// Complex values are summarised as log2 of their magnitude. The report is STAT_Report.csv, written at the end of the run.
+#define     STAT_HIST_BINS          32
+#define     STAT_LOG2_FLOOR         -64.0       // log2 magnitude of a zero complex value
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Module structure
+
+struct strStatCol
+{
+    double      Mean;
+    double      M2;                 // Sum of squared differences from the mean
+    double      Min;
+    double      Max;
+    uint32_t    Hist[STAT_HIST_BINS + 2];   // [0] below HistLo, [STAT_HIST_BINS + 1] at or above HistHi
+};
+
+struct strSTAT
+{
+    bool        Enable;
+    uint32_t    Blocks;             // Blocks summarised; the count of every column
+    int24_t     NumSignals;
+    const strSimSignal* Signals[NUM_TRACE_SIGNALS];
+    uint32_t    ColOffset[NUM_TRACE_SIGNALS];       // Of each signal's first column in Cols
+    int24_t     Width[NUM_TRACE_SIGNALS];
+    double      HistScale[NUM_TRACE_SIGNALS];       // Histogram bins per unit value
+    uint32_t    NumCols;
+    strStatCol* Cols;               // All columns of all signals; allocated once at init
+};
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Function prototypes
+
+void STAT_Init();
+void STAT_Update();
+void STAT_Report();
+
+#endif  // _STAT_H
@@ -35,6 +35,7 @@ int24_t tap;
         SYS.MicEnergy[i] = to_frac48(0);
         SYS.Error[i] = to_frac24(0);        // Complex, both parts set to 0
         SYS.BinEnergy[i] = to_frac48(0);
+        SYS.BinEnergyLog2[i] = to_frac16(0);
         SYS.FwdGainLog2[i] = to_frac16(0);  // Unity gain
         SYS.FwdSynBuf[i] = to_frac24(0);    // Complex, both parts set to 0
 
@@ -44,12 +45,21 @@ int24_t tap;
         SYS.RevEnergy[i] = to_frac48(0);
     }
 
+    SYS.BinEnergyLog2Valid = (uint32_t)(-1);     // Keep the reset values above until the first energy update
+
     SYS.RevBufPtr = 0;
     SYS.RevAnaPtr = -1;     // Back up one sample so pre-adjust goes to 0
+    SYS.RevAnaFrames = FBC_RevAnaFrames();
+    SYS.RevQuietFrames = SYS.RevAnaFrames;      // RevAnaBuf cleared above
 
     for (i = 0; i < MAX_REV_DELAY; i++)
         SYS.RevDelayBuf[i] = to_frac24(0);
 
+    SYS.LowPowerMode = SYS_Params.Profile.LowPowerMode;
+    SYS.LowPowerThreshLin = to_frac24(pow(2.0, SYS_Params.Profile.LowPowerThresh));   // TODO: Use exp2 approximation for fixed point
+    SYS.QuietBlock = false;
+    SYS.QuietBlockCount = 0;
+
     SYS.AgcoLevelLog2 = to_frac16(-40.0);
     SYS.AgcoGainLog2 = SYS_Params.Profile.AgcoGain;
 
@@ -74,12 +84,34 @@ int24_t tap;
 void SYS_FENG_ApplyInputGain()
 {
 int24_t i;
+frac24_t Peak;
 
+    Peak = to_frac24(0);
     for (i = 0; i < BLOCK_SIZE; i++)
     {
         SYS.FwdAnaIn[i] = mult_log2(SYS.InBuf[i], SYS.MicCalGainLog2);
+        Peak = max24(Peak, abs_f24(SYS.FwdAnaIn[i]));
     }
     // TODO: If need to ramp input on start-up, modify SYS.MicCalGainLog2 here until it matches SYS_Params.Persist.InpMicGain
+
+    // Low-power detector. Quiet blocks go through the same stages, but the transforms and FBC filtering
+    // are skipped once their inputs are all zero; see SYS_HEAR_WolaFwdAnalysis() and following
+    if (SYS.LowPowerMode == SYS_LOWPWR_EXACT)
+        SYS.QuietBlock = (Peak == 0.0);
+    else if (SYS.LowPowerMode == SYS_LOWPWR_APPROX)
+    {
+        SYS.QuietBlock = (Peak < SYS.LowPowerThreshLin);
+        if (SYS.QuietBlock)
+        {
+            for (i = 0; i < BLOCK_SIZE; i++)
+                SYS.FwdAnaIn[i] = to_frac24(0);     // Squelch; treat as digital silence from here on
+        }
+    }
+    else
+        SYS.QuietBlock = false;
+
+    if (SYS.QuietBlock)
+        SYS.QuietBlockCount++;
 }
 
 
@@ -88,6 +120,15 @@ void SYS_HEAR_WolaFwdAnalysis()
 int24_t i;
 frac24_t Ar, Ai;
 
+    // Low-power path: nothing but zeros left in the analysis window, so the output is zero
+    if (SYS.QuietBlock && WOLA_AnaSilentAfterZeroBlock(&SYS.FwdWOLA))
+    {
+        WOLA_AdvanceAnalysis(&SYS.FwdWOLA, SYS.FwdAnaIn, SYS.FwdAnaBuf);
+        for (i = 0; i < WOLA_NUM_BINS; i++)
+            SYS.MicEnergy[i] = to_frac48(0);
+        return;
+    }
+
     WOLA_Analyze(&SYS.FwdWOLA, SYS.FwdAnaIn, SYS.FwdAnaBuf);     // Ignoring return value
 
     if (WOLA_STACKING == WOLA_STACKING_EVEN)
@@ -109,6 +150,7 @@ void SYS_HEAR_WolaRevAnalysis()
 int24_t i;
 int24_t bufp, dlyp;     // Buffer and Delay pointers
 frac24_t Ar, Ai;
+bool RevInZero;
 
     bufp = SYS.RevBufPtr;       // buffer pointer; where to put samples into RevDelayBuf
     dlyp = (bufp - FBC_Params.Persist.BulkDelay) & MAX_REV_DLY_MASK;    // Delay pointer into buffer; where to get samples from RevDelayBuf to put into RevAnaIn
@@ -122,9 +164,28 @@ frac24_t Ar, Ai;
     SYS.RevBufPtr = bufp;     // update pointer
 
     // Adjust circular pointer into reverse analysis buffer
-    dlyp = (SYS.RevAnaPtr+1) & FBC_REV_ANA_SIZE_MASK;   // Point to newest value (overwrite of oldest value)
+    dlyp = SYS.RevAnaPtr+1;         // Point to newest value (overwrite of oldest value)
+    dlyp = (dlyp >= SYS.RevAnaFrames) ? 0 : dlyp;
     SYS.RevAnaPtr = dlyp;     
 
+    // Low-power path: output fed back is still silent and the analysis window is clear
+    if (SYS.LowPowerMode != SYS_LOWPWR_OFF)
+    {
+        RevInZero = true;
+        for (i = 0; i < BLOCK_SIZE; i++)
+            RevInZero = RevInZero && (SYS.RevAnaIn[i] == 0.0);
+        if (RevInZero && WOLA_AnaSilentAfterZeroBlock(&SYS.RevWOLA))
+        {
+            WOLA_AdvanceAnalysis(&SYS.RevWOLA, SYS.RevAnaIn, SYS.RevAnaBuf[dlyp]);
+            for (i = 0; i < WOLA_NUM_BINS; i++)
+                SYS.RevEnergy[i] = to_frac48(0);
+            if (SYS.RevQuietFrames < SYS.RevAnaFrames)
+                SYS.RevQuietFrames++;
+            return;
+        }
+    }
+    SYS.RevQuietFrames = 0;
+
     WOLA_Analyze(&SYS.RevWOLA, SYS.RevAnaIn, SYS.RevAnaBuf[dlyp]);      // Ignoring return value
 
     if (WOLA_STACKING == WOLA_STACKING_EVEN)
@@ -154,9 +215,28 @@ frac24_t Er, Ei;
 
         Er = SYS.Error[i].Real();   Ei = SYS.Error[i].Imag();
         SYS.BinEnergy[i] = sat48(Er*Er + Ei*Ei);
-        SYS.BinEnergyLog2[i] = shr(log2_approx(SYS.BinEnergy[i]),1);    // divide by 2 to account for being squared
     }
+    SYS.BinEnergyLog2Valid = 0;     // log2 energies are only computed for the bins a consumer asks for
+
+}
 
+
+// Make sure SYS.BinEnergyLog2[FirstBin..LastBin] is up to date with SYS.BinEnergy. Consumers call this for
+// the bins they read this block; bins already computed since the last energy update are not redone
+void SYS_DemandBinEnergyLog2(int24_t FirstBin, int24_t LastBin)
+{
+int24_t i;
+uint32_t BinMask;
+
+    for (i = FirstBin; i <= LastBin; i++)
+    {
+        BinMask = (uint32_t)1 << i;
+        if (!(SYS.BinEnergyLog2Valid & BinMask))
+        {
+            SYS.BinEnergyLog2[i] = shr(log2_approx(SYS.BinEnergy[i]),1);    // divide by 2 to account for being squared
+            SYS.BinEnergyLog2Valid |= BinMask;
+        }
+    }
 }
 
 
@@ -182,6 +262,20 @@ void SYS_HEAR_WolaFwdSynthesis()
 {
 uint16_t i;
 frac24_t Ar, Ai;
+bool SynInZero;
+
+    // Low-power path: an all-zero synthesis input only moves the overlap-add buffer along
+    if (SYS.QuietBlock)
+    {
+        SynInZero = true;
+        for (i = 0; i < WOLA_NUM_BINS; i++)
+            SynInZero = SynInZero && (SYS.FwdSynBuf[i].Real() == 0.0) && (SYS.FwdSynBuf[i].Imag() == 0.0);
+        if (SynInZero)
+        {
+            WOLA_AdvanceSynthesis(&SYS.FwdWOLA, SYS.FwdSynOut);
+            return;
+        }
+    }
 
     for (i = 0; i < WOLA_NUM_BINS; i++)
     {
@@ -193,23 +287,36 @@ frac24_t Ar, Ai;
 }
 
 
-void SYS_FENG_AgcO()
+// AGCo is split into level tracking and gain application, so that instances can share a level
+// between the two (see MCH_LinkAgco()). Unlinked, this is the same per-sample computation.
+void SYS_FENG_AgcoLevel()
 {
 int24_t i;
-frac16_t BbGainLog2;
 frac24_t TC;
 frac16_t Diff;
 frac16_t LevelLog2;
-frac16_t ThreshDiff;
 
     for (i = 0; i < BLOCK_SIZE; i++)
     {
-        BbGainLog2 = SYS_Params.Profile.VCGain + EQ_Params.Profile.BroadbandGain + SYS_Params.Profile.AgcoGain;     // Combine all broadband gains
         LevelLog2 = log2_approx(abs_f24(SYS.FwdSynOut[i]));
         Diff = LevelLog2 - SYS.AgcoLevelLog2;
         TC = (Diff > 0) ? AGCO_ATK_TC : AGCO_REL_TC;
         SYS.AgcoLevelLog2 = rnd_sat24(TC*Diff) + SYS.AgcoLevelLog2;
-        ThreshDiff = SYS_Params.Persist.AgcoThresh - SYS.AgcoLevelLog2;
+        SYS.AgcoLevelBuf[i] = SYS.AgcoLevelLog2;
+    }
+}
+
+
+void SYS_FENG_AgcoGain()
+{
+int24_t i;
+frac16_t BbGainLog2;
+frac16_t ThreshDiff;
+
+    for (i = 0; i < BLOCK_SIZE; i++)
+    {
+        BbGainLog2 = SYS_Params.Profile.VCGain + EQ_Params.Profile.BroadbandGain + SYS_Params.Profile.AgcoGain;     // Combine all broadband gains
+        ThreshDiff = SYS_Params.Persist.AgcoThresh - SYS.AgcoLevelBuf[i];
         if (BbGainLog2 > ThreshDiff)  // if ((SYS.AgcoLevelLog2+BbGainLog2) > SYS_Params.Persist.AgcoThresh); if proposed level exceeds threshold
         // If the result of applying all the gains is going to exceed threshold
         // then apply as much as possible = the amount of gain that will take level to thresh
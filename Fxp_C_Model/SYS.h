@@ -18,9 +18,17 @@
 #define     AGCO_ATK_TC     (1.0/32.0)      // TODO: Convert to fixed point
 #define     AGCO_REL_TC     (1.0/512.0)
 
+#define     SYS_LOWPWR_OFF      0           // Values for SYS_Params.Profile.LowPowerMode
+#define     SYS_LOWPWR_EXACT    1           // Skip work only when the result is known to be all zero
+#define     SYS_LOWPWR_APPROX   2           // Also squelch input below LowPowerThresh and freeze FBC adaptation
+
 #define     MAX_REV_DELAY       32          // USE POWER OF TWO for easy roll-over
 #define     MAX_REV_DLY_MASK    (MAX_REV_DELAY-1)
 
+#if (WOLA_NUM_BINS > 32)
+#error "SYS.BinEnergyLog2Valid holds one bit per bin; widen it for more than 32 bins"
+#endif
+
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // Module structure
@@ -30,16 +38,22 @@ struct strSYS
     frac16_t    MicCalGainLog2;
     frac24_t    InBuf[BLOCK_SIZE];
     frac24_t    FwdAnaIn[BLOCK_SIZE];
+    int24_t     LowPowerMode;       // SYS_LOWPWR_xxx, from profile
+    frac24_t    LowPowerThreshLin;  // Linear peak threshold for SYS_LOWPWR_APPROX
+    bool        QuietBlock;         // Input block is silent (or squelched); low-power path may be taken this block
+    uint32_t    QuietBlockCount;    // Number of quiet blocks, for simulation statistics
     Complex24   FwdAnaBuf[WOLA_NUM_BINS];
     frac48_t    MicEnergy[WOLA_NUM_BINS];
     Complex24   Error[WOLA_NUM_BINS];
     frac48_t    BinEnergy[WOLA_NUM_BINS];
-    frac16_t    BinEnergyLog2[WOLA_NUM_BINS];
+    frac16_t    BinEnergyLog2[WOLA_NUM_BINS];       // Derived from BinEnergy on demand; see SYS_DemandBinEnergyLog2()
+    uint32_t    BinEnergyLog2Valid;                 // One bit per bin; set when BinEnergyLog2[bin] matches current BinEnergy[bin]
     frac16_t    FwdGainLog2[WOLA_NUM_BINS];
     Complex24   FwdSynBuf[WOLA_NUM_BINS];
     frac24_t    FwdSynOut[BLOCK_SIZE];
     frac24_t    OutBuf[BLOCK_SIZE];
     frac16_t    AgcoLevelLog2;
+    frac16_t    AgcoLevelBuf[BLOCK_SIZE];       // Per-sample AGCo level used for the gain decision; may be replaced by a linked level, see MCH_LinkAgco()
     frac16_t    AgcoGainLog2;
     frac16_t    DynamicGainLog2[WOLA_NUM_BINS];
     frac16_t    LimitedFwdGain[WOLA_NUM_BINS];
@@ -49,7 +63,9 @@ struct strSYS
     frac24_t    RevAnaIn[BLOCK_SIZE];
     Complex24   RevAnaBuf[FBC_REV_ANA_BUF_SIZE][WOLA_NUM_BINS];     // Order dimensions this way to pass RevAnaBuf[] as pointer
     int24_t     RevAnaPtr;      // Points to latest samples in RevAnaBuf; start point for filtering and adaptation
+    int24_t     RevAnaFrames;   // Depth of the RevAnaBuf ring; frames spanned by the FBC filter shape
     frac48_t    RevEnergy[WOLA_NUM_BINS];
+    int24_t     RevQuietFrames;     // Consecutive all-zero frames written into RevAnaBuf (saturates at RevAnaFrames)
 
     strWOLA     FwdWOLA;
     strWOLA     RevWOLA;
@@ -64,9 +80,11 @@ void SYS_FENG_ApplyInputGain();
 void SYS_HEAR_WolaFwdAnalysis();
 void SYS_HEAR_WolaRevAnalysis();
 void SYS_HEAR_ErrorSubAndEnergy();
+void SYS_DemandBinEnergyLog2(int24_t FirstBin, int24_t LastBin);
 void SYS_HEAR_ApplySubbandGain();
 void SYS_HEAR_WolaFwdSynthesis();
-void SYS_FENG_AgcO();
+void SYS_FENG_AgcoLevel();
+void SYS_FENG_AgcoGain();
 
 
 #endif  // _SYS_H
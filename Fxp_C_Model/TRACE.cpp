@@ -0,0 +1,275 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// Binary trace files (simulation only) for fixed-point C code
+// Writes per-block signal traces as NumPy .npy files, from the processing thread or from a writer thread
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#include "Common.h"
+
+static const char* const TRACE_Descr[TRACE_NUM_TYPES] = { "<f8", "<c16", "<i4" };
+static const uint32_t TRACE_ElemBytes[TRACE_NUM_TYPES] = { 8, 16, 4 };
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Ring access. Positions are free-running byte counts; copies wrap at the end of the ring.
+
+static void TRACE_RingCopyIn(uint32_t Pos, const void* Src, uint32_t Len)
+{
+uint32_t Idx = Pos & TRACE_RING_MASK;
+uint32_t First = (Len < (TRACE_RING_BYTES - Idx)) ? Len : (TRACE_RING_BYTES - Idx);
+
+    memcpy(&TRACE.Ring[Idx], Src, First);
+    memcpy(&TRACE.Ring[0], (const uint8_t*)Src + First, Len - First);
+}
+
+
+// Writer thread: drain published rows to the files until told to quit with the ring empty.
+// Gets the instance's TRACE by pointer; TRACE is thread_local.
+static void TRACE_Writer(strTRACE* Log)
+{
+strTraceRec Rec;
+uint32_t Head;
+uint32_t Tail = Log->Tail.load(std::memory_order_relaxed);
+uint32_t Idx, First;
+bool Quit;
+
+    while (1)
+    {
+        Quit = Log->Quit.load(std::memory_order_acquire);     // Before Head: rows published before Quit are written
+        Head = Log->Head.load(std::memory_order_acquire);
+        if (Head == Tail)
+        {
+            if (Quit)
+                break;
+            std::this_thread::sleep_for(std::chrono::microseconds(TRACE_POLL_US));
+            continue;
+        }
+
+        while (Tail != Head)
+        {
+            Idx = Tail & TRACE_RING_MASK;
+            First = ((uint32_t)sizeof(Rec) < (TRACE_RING_BYTES - Idx)) ? (uint32_t)sizeof(Rec) : (TRACE_RING_BYTES - Idx);
+            memcpy(&Rec, &Log->Ring[Idx], First);
+            memcpy((uint8_t*)&Rec + First, &Log->Ring[0], sizeof(Rec) - First);
+            Tail += sizeof(Rec);
+
+            Idx = Tail & TRACE_RING_MASK;
+            First = (Rec.Len < (TRACE_RING_BYTES - Idx)) ? Rec.Len : (TRACE_RING_BYTES - Idx);
+            fwrite(&Log->Ring[Idx], 1, First, Rec.Tr->fp);
+            fwrite(&Log->Ring[0], 1, Rec.Len - First, Rec.Tr->fp);
+            Rec.Tr->Blocks++;
+            Tail += Rec.Len;
+
+            Log->Tail.store(Tail, std::memory_order_release);     // Free the space record by record
+        }
+    }
+}
+
+
+// Write the header at the start of the file. The dict is padded with spaces to a fixed length, and the block
+// count has a fixed width, so the rewrite at close lands on the same bytes.
+static void TRACE_WriteHeader(strTrace* Tr)
+{
+char Header[TRACE_HEADER_LEN + 1];
+int Len;
+uint16_t DictLen = TRACE_HEADER_LEN - 10;
+
+    memcpy(Header, "\x93NUMPY\x01\x00", 8);
+    Header[8] = (char)(DictLen & 0xFF);
+    Header[9] = (char)(DictLen >> 8);
+    Len = sprintf_s(&Header[10], TRACE_HEADER_LEN + 1 - 10, "{'descr': '%s', 'fortran_order': False, 'shape': (%10u, %d), }",
+                    TRACE_Descr[Tr->Type], Tr->Blocks, Tr->Width);
+    memset(&Header[10 + Len], ' ', TRACE_HEADER_LEN - 10 - Len);
+    Header[TRACE_HEADER_LEN - 1] = '\n';
+
+    fseek(Tr->fp, 0, SEEK_SET);
+    fwrite(Header, 1, TRACE_HEADER_LEN, Tr->fp);
+}
+
+
+// Open <ResultPath>/<FilePrefix><Name>.npy
+void TRACE_Open(strTrace* Tr, const char* Name, int24_t Type, int24_t Width)
+{
+char fname[256];
+
+    Tr->fp = NULL;
+    Tr->Type = Type;
+    Tr->Width = Width;
+    Tr->Blocks = 0;
+
+    sprintf_s(fname, "%s/%s%s.npy", SIM.ResultPath, SIM.FilePrefix, Name);
+    fopen_s(&Tr->fp, fname, "wb");
+    if (Tr->fp == NULL)
+    {
+        printf("\nERROR! Could not open trace file %s for write...\n\n", fname);
+        return;
+    }
+    TRACE_WriteHeader(Tr);
+}
+
+
+// Mark a signal as not traced; writes and close are then no-ops
+void TRACE_Clear(strTrace* Tr)
+{
+    Tr->fp = NULL;
+    Tr->Blocks = 0;
+}
+
+
+// One row of a trace: written here, or queued for the writer thread
+static void TRACE_Row(strTrace* Tr, const void* Data, uint32_t Len)
+{
+strTraceRec Rec;
+uint32_t Need = sizeof(Rec) + Len;
+uint32_t Fill;
+
+    if (TRACE.Mode == TRACE_MODE_SYNC)
+    {
+        fwrite(Data, 1, Len, Tr->fp);
+        Tr->Blocks++;
+        return;
+    }
+
+    if (TRACE.BlockDropped)
+        return;
+
+    Fill = TRACE.BlockHead - TRACE.Tail.load(std::memory_order_acquire);
+    if ((TRACE_RING_BYTES - Fill) < Need)
+    {
+        if (TRACE.Mode == TRACE_MODE_ASYNC_DROP)
+        {
+            TRACE.BlockDropped = true;
+            return;
+        }
+        TRACE.WaitCount++;
+        do
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(TRACE_POLL_US));
+            Fill = TRACE.BlockHead - TRACE.Tail.load(std::memory_order_acquire);
+        } while ((TRACE_RING_BYTES - Fill) < Need);
+    }
+
+    Rec.Tr = Tr;
+    Rec.Len = Len;
+    TRACE_RingCopyIn(TRACE.BlockHead, &Rec, sizeof(Rec));
+    TRACE_RingCopyIn(TRACE.BlockHead + sizeof(Rec), Data, Len);
+    TRACE.BlockHead += Need;
+
+    Fill += Need;
+    if (Fill > TRACE.MaxFill)
+        TRACE.MaxFill = Fill;
+}
+
+
+// Bytes in one row of a trace
+uint32_t TRACE_RowBytes(int24_t Type, int24_t Width)
+{
+    return TRACE_ElemBytes[Type]*(uint32_t)Width;
+}
+
+
+// Write one block's row, already in the file's format: Width values of the trace's type, complex as real/imag pairs
+void TRACE_WriteRow(strTrace* Tr, const void* Row)
+{
+    if (Tr->fp != NULL)
+        TRACE_Row(Tr, Row, TRACE_RowBytes(Tr->Type, Tr->Width));
+}
+
+
+// Write NumRows consecutive rows straight to the file, in any mode; for data already captured elsewhere
+void TRACE_WriteRows(strTrace* Tr, const void* Rows, uint32_t NumRows)
+{
+    if (Tr->fp != NULL)
+    {
+        fwrite(Rows, TRACE_RowBytes(Tr->Type, Tr->Width), NumRows, Tr->fp);
+        Tr->Blocks += NumRows;
+    }
+}
+
+
+// Fill in the block count and close. In the async modes, call after TRACE_StopLog()
+void TRACE_Close(strTrace* Tr)
+{
+    if (Tr->fp != NULL)
+    {
+        TRACE_WriteHeader(Tr);
+        fclose(Tr->fp);
+        Tr->fp = NULL;
+    }
+}
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Asynchronous writing
+
+// Call after the trace files are opened
+void TRACE_StartLog(int24_t Mode)
+{
+    TRACE.Mode = ((Mode >= 0) && (Mode < TRACE_NUM_MODES)) ? Mode : TRACE_MODE_SYNC;
+    TRACE.Head.store(0);
+    TRACE.Tail.store(0);
+    TRACE.Quit.store(false);
+    TRACE.BlockHead = 0;
+    TRACE.BlockDropped = false;
+    TRACE.QueuedBlocks = 0;
+    TRACE.DroppedBlocks = 0;
+    TRACE.WaitCount = 0;
+    TRACE.MaxFill = 0;
+
+    if (TRACE.Mode == TRACE_MODE_SYNC)
+        return;
+
+    TRACE.Ring = (uint8_t*)malloc(TRACE_RING_BYTES);
+    if (TRACE.Ring == NULL)
+    {
+        printf("\nERROR! Could not allocate %u KB for the trace ring; writing traces inline...\n\n", TRACE_RING_BYTES >> 10);
+        TRACE.Mode = TRACE_MODE_SYNC;
+        return;
+    }
+    TRACE.Writer = std::thread(TRACE_Writer, &TRACE);
+}
+
+
+// Rows of all traces between TRACE_BeginBlock() and TRACE_EndBlock() are published to the writer together,
+// or in drop mode dropped together, so the trace files stay row-aligned
+void TRACE_BeginBlock()
+{
+    TRACE.BlockDropped = false;
+}
+
+
+void TRACE_EndBlock()
+{
+    if (TRACE.Mode == TRACE_MODE_SYNC)
+        return;
+
+    if (TRACE.BlockDropped)
+    {
+        TRACE.BlockHead = TRACE.Head.load(std::memory_order_relaxed);
+        TRACE.DroppedBlocks++;
+    }
+    else
+    {
+        TRACE.Head.store(TRACE.BlockHead, std::memory_order_release);
+        TRACE.QueuedBlocks++;
+    }
+}
+
+
+// Wait for the writer to empty the ring, stop it and free the ring
+void TRACE_StopLog()
+{
+    if (TRACE.Mode != TRACE_MODE_SYNC)
+    {
+        TRACE.Quit.store(true, std::memory_order_release);
+        TRACE.Writer.join();
+    }
+    free(TRACE.Ring);
+    TRACE.Ring = NULL;
+}
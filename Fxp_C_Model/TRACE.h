@@ -0,0 +1,105 @@
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+//
+// Binary trace files (simulation only) header file for fixed-point C code
+//
+// Novidan, Inc. (c) 2023.  May not be used or copied without prior consent.
+//
+// Bryant Sorensen, author
+// Started 19 Oct 2026
+//
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#ifndef _TRACE_H
+#define _TRACE_H
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Includes
+
+#include <thread>
+#include <atomic>
+#include <chrono>
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Defines
+
+// One file per signal, one row per block, in NumPy .npy format (version 1.0): numpy.load() gives an array
+// of shape (blocks, values per block). The header is fixed width, with the block count written at close.
+// Data is raw little-endian, as written by the x86/x64 host.
+#define     TRACE_TYPE_F8           0       // frac16_t, frac24_t, frac48_t (all double in the model)
+#define     TRACE_TYPE_C16          1       // Complex24, as real/imag double pairs
+#define     TRACE_TYPE_I4           2       // int24_t
+#define     TRACE_NUM_TYPES         3
+
+#define     TRACE_HEADER_LEN        128     // Magic, version, length and padded dict; multiple of 64 as numpy writes it
+#define     TRACE_MAX_VALS          (WOLA_NUM_BINS*FBC_COEFFS_PER_BIN)      // Widest signal: FBC coefficients
+#define     TRACE_MAX_ROW_DBL       (2*TRACE_MAX_VALS)                      // Doubles for the widest row; complex values are pairs
+
+// Writing mode. In the async modes the processing thread only copies each block's trace rows into a
+// single-producer/single-consumer ring, and a writer thread (one per instance) does the file I/O.
+#define     TRACE_MODE_SYNC         0       // Write from the processing thread
+#define     TRACE_MODE_ASYNC_WAIT   1       // Ring full: processing thread waits for the writer; lossless
+#define     TRACE_MODE_ASYNC_DROP   2       // Ring full: the whole block is dropped from all traces; never waits
+#define     TRACE_NUM_MODES         3
+
+#define     TRACE_RING_BYTES        (1 << 22)       // 4 MB; several hundred blocks with all modules traced. Power of 2. Allocated in the async modes only
+#define     TRACE_RING_MASK         (TRACE_RING_BYTES - 1)
+#define     TRACE_POLL_US           200             // Sleep of the writer when the ring is empty, and of a waiting producer
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Trace file structure
+
+struct strTrace
+{
+    FILE*       fp;                 // NULL if not traced
+    int24_t     Type;               // TRACE_TYPE_xxx
+    int24_t     Width;              // Values per block
+    uint32_t    Blocks;             // Rows written so far
+};
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Module structure (asynchronous writer; one per instance)
+
+// Ring record: header, then Len bytes of row data. Records may wrap around the end of the ring.
+struct strTraceRec
+{
+    strTrace*   Tr;
+    uint32_t    Len;
+};
+
+struct strTRACE
+{
+    int24_t     Mode;               // TRACE_MODE_xxx
+    uint8_t*    Ring;               // TRACE_RING_BYTES; allocated by TRACE_StartLog(), freed by TRACE_StopLog()
+    std::atomic<uint32_t>   Head;   // Free-running byte counts; written by the processing thread only
+    std::atomic<uint32_t>   Tail;   // Written by the writer thread only
+    std::atomic<bool>       Quit;
+    std::thread Writer;
+
+// Processing thread only
+    uint32_t    BlockHead;          // Head including the current block's rows; published at the end of the block
+    bool        BlockDropped;       // A row of the current block did not fit; drop mode
+    uint32_t    QueuedBlocks;
+    uint32_t    DroppedBlocks;
+    uint32_t    WaitCount;          // Times the processing thread waited for the writer (backpressure)
+    uint32_t    MaxFill;            // Peak ring fill, bytes
+};
+
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Function prototypes
+
+void TRACE_Open(strTrace* Tr, const char* Name, int24_t Type, int24_t Width);
+void TRACE_Clear(strTrace* Tr);
+uint32_t TRACE_RowBytes(int24_t Type, int24_t Width);
+void TRACE_WriteRow(strTrace* Tr, const void* Row);
+void TRACE_WriteRows(strTrace* Tr, const void* Rows, uint32_t NumRows);
+void TRACE_Close(strTrace* Tr);
+
+void TRACE_StartLog(int24_t Mode);
+void TRACE_BeginBlock();
+void TRACE_EndBlock();
+void TRACE_StopLog();
+
+#endif  // _TRACE_H
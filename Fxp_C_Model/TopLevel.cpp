@@ -19,45 +19,44 @@ using namespace std;
 // TODO: For Simulation: Use module enables to decide whether to output files for that module
 //      Some modules may always have output, like WOLA
 
-strSIM  SIM;            // Declared as global because both top level and SIM modules use it
+thread_local strSIM  SIM;           // Global because both top level and SIM modules use it; one per processing instance
+thread_local strBENCH BENCH;        // FBC benchmark; simulation only
+thread_local strTRACE TRACE;        // Trace file writer thread and its ring; simulation only
+thread_local strFREC FREC;          // Flight recorder; simulation only
+thread_local strSTAT STAT;          // Per-column summary statistics of traced signals; simulation only
+thread_local strGEN GEN;            // Input test signal generator; simulation only
 
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // Instantiate module structures as globals
+// Module state and parameters are thread_local; each thread is one processing instance (see MCH.h)
 // TODO: Determine if we want to make module classes instead of structures
 
-strWDRC WDRC;
-strSYS  SYS;
-strFBC  FBC;
-strNR   NR;
+thread_local strWDRC WDRC;
+thread_local strSYS  SYS;
+thread_local strFBC  FBC;
+thread_local strNR   NR;
+thread_local strPIPE PIPE;
+
+strMCH  MCH;
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // Instantiate module parameter structures
 
-strParams_WDRC  WDRC_Params;
-strParams_SYS   SYS_Params;
-strParams_FBC   FBC_Params;
-strParams_EQ    EQ_Params;
-strParams_NR    NR_Params;
+thread_local strParams_WDRC  WDRC_Params;
+thread_local strParams_SYS   SYS_Params;
+thread_local strParams_FBC   FBC_Params;
+thread_local strParams_EQ    EQ_Params;
+thread_local strParams_NR    NR_Params;
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-// Main function. Drives simulation, calls all modules
+// Per-instance firmware init and block processing; used directly by the single-instance
+// simulation, and by each instance thread for multi-channel input
 
 #include "FW_Param_Init.cpp"      // Include init routine code here. Don't want to add Common.h to auto-generated init code, as this may vary by project
 
-int main (int argc, char* argv[])
+static void TOP_InitInstance()
 {
-cWAVops WavInp;
-cWAVops WavOutp;
-int N;
-int BlocksInSim;
-int CurBlock;
-int32_t Buf[8];
-int8_t RetVal = 0;
-
-//++++++++++++++++++++
-// Firmware
-
 // Initialize all parameters (in actual FW, this is call to EEPROM read)
     FW_Param_Init();
 
@@ -66,96 +65,193 @@ int8_t RetVal = 0;
     WDRC_Init();
     FBC_Init();     // NOTE: FBC_Init MUST be called after WDRC_Init to capture correct target gains
     NR_Init();
+    PIPE_Init();    // NOTE: PIPE_Init MUST be called after all other module inits; it schedules only enabled stages
+}
+
+
+// Process one block of BLOCK_SIZE samples in place
+static void TOP_ProcessBlock(int32_t* Buf)
+{
+const double Scale24 = 0.00000011920928955078125;   // 2^-23
+int k;
 
 //++++++++++++++++++++
 // Simulation
 
-// Simulation variables 
+    for (k = 0; k < BLOCK_SIZE; k++)
+        SYS.InBuf[k] = to_frac24((double)Buf[k]*Scale24);   // This needs to be replaced with moving data in from audio I/O block
 
-const double Scale24 = 0.00000011920928955078125;   // 2^-23
-int k;
+    SIM_Feedback(SYS.InBuf, SYS.OutBuf);
 
-// Parse command line options until it returns -1
-    RetVal = parse_command_line(argc, argv);
-    if (RetVal != 0)
-        exit(RetVal);
+//++++++++++++++++++++
+// Firmware
+
+    PIPE_Run();     // Calls the module processing functions scheduled in PIPE_Init
+
+//++++++++++++++++++++
+// Simulation
+
+    for (k = 0; k < BLOCK_SIZE; k++)
+        Buf[k] = (int32_t)(round(SYS.OutBuf[k]/Scale24));       // This needs to be replaced with sending data to audio I/O block
 
-// Get elements of simulation initialized, including output file names; 
-// call AFTER init of parameters and AFTER parsing command line to get file names & paths
+    SIM_LogFiles();
+    FREC_Update();
+    BENCH_Update();
+}
 
-    SIM_Init();     
+
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Input source: the -s .wav file, or the -g signal generator (mono). SIM ONLY
+
+static cWAVops WavInp;
+
+// Opens the source; gives its channels and samples per channel
+static void TOP_OpenInput(int* NumChannels, int* N)
+{
+    if (GEN.Type != GEN_TYPE_NONE)
+    {
+        GEN_Init();
+        *NumChannels = 1;
+        *N = (int)GEN.NumSamples;
+        return;
+    }
 
 // Open input .wav file, check its parameters, get size
 // Call AFTER parsing command line to get file name
-
     WavInp.OpenReadFile(SIM.InfileName);
-    if ((WavInp.GetBitsPerSample() != 24) || (WavInp.GetSampleRate() != BASEBAND_SAMPLE_RATE) || (!WavInp.IsMono()))
+    *NumChannels = WavInp.GetNumChannels();
+    if ((WavInp.GetBitsPerSample() != 24) || (WavInp.GetSampleRate() != BASEBAND_SAMPLE_RATE) || (*NumChannels < 1))
         printf("Something wrong with input file!\n");
+    *N = WavInp.GetNumSamples();
+}
 
-    N = WavInp.GetNumSamples();
-    BlocksInSim = N >> 3;    // Round off to modulo 8 floor
-    N = BlocksInSim << 3;    // Update number of samples to be multiple of 8
 
-// Create output .wav file; call AFTER simulation init to get file name
+// Next NumVals values, interleaved if multi-channel
+static void TOP_ReadInput(uint16_t NumVals, int32_t* Buf)
+{
+    if (GEN.Type != GEN_TYPE_NONE)
+        GEN_ReadNVals(NumVals, Buf);
+    else
+        WavInp.ReadNVals(NumVals, Buf);
+}
+
+
+static void TOP_CloseInput()
+{
+    if (GEN.Type == GEN_TYPE_NONE)
+        WavInp.CloseFile();
+}
 
-    WavOutp.OpenMonoWriteFile(SIM.OutFileName, BASEBAND_SAMPLE_RATE, 24, N);
 
-// Do simulation, going through all blocks
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Main function. Drives simulation, calls all modules
 
-    for (CurBlock = 0; CurBlock < BlocksInSim; CurBlock++)
+int main (int argc, char* argv[])
+{
+cWAVops WavOutp;
+int N;
+int BlocksInSim;
+int CurBlock;
+int NumChannels;
+int ChunkBlocks;
+int32_t Buf[8];
+int8_t RetVal = 0;
+
+// Parse command line options until it returns -1
+    RetVal = parse_command_line(argc, argv);
+    if (RetVal != 0)
+        exit(RetVal);
+
+// WDRC characterization drives WDRC directly; no .wav file
+    if (SIM.WdrcChar)
     {
+        TOP_InitInstance();
+        BENCH_WdrcChar();
+        exit(0);
+    }
 
-        WavInp.ReadNVals(8, Buf);       // SIM ONLY
-        for (k = 0; k < BLOCK_SIZE; k++)
-            SYS.InBuf[k] = to_frac24((double)Buf[k]*Scale24);   // This needs to be replaced with moving data in from audio I/O block
+// Open the input source; call AFTER parsing command line to get file name or generator settings
 
-        SIM_Feedback(SYS.InBuf, SYS.OutBuf);
+    TOP_OpenInput(&NumChannels, &N);
+    if (NumChannels > MCH_MAX_INSTANCES)
+    {
+        printf("\nInput file has %d channels; at most %d are supported. Now exiting...\n\n", NumChannels, MCH_MAX_INSTANCES);
+        exit(3);
+    }
+
+    BlocksInSim = N >> 3;    // Round off to modulo 8 floor
+    N = BlocksInSim << 3;    // Update number of samples to be multiple of 8
+
+    MCH_Init(NumChannels, SIM.AgcoLink ? MCH_LINK_AGCO_MAX : MCH_LINK_NONE);
+
+    if (MCH.NumInst == 1)
+    {
+    // Single instance, processed on this thread
 
 //++++++++++++++++++++
 // Firmware
 
-        SYS_FENG_ApplyInputGain();
-        SYS_HEAR_WolaFwdAnalysis();
-        SYS_HEAR_WolaRevAnalysis();
+        TOP_InitInstance();
+
+//++++++++++++++++++++
+// Simulation
+
+    // Get elements of simulation initialized, including output file names; 
+    // call AFTER init of parameters and AFTER parsing command line to get file names & paths
 
-        NR_Main();
+        SIM_Init();     
 
-        FBC_HEAR_Levels();
-        FBC_HEAR_DoFiltering();
+        PIPE_PrintSchedule();
 
-        SYS_HEAR_ErrorSubAndEnergy();
+    // Create output .wav file; call AFTER simulation init to get file name
 
-        WDRC_Main();
-        
-        FBC_FilterAdaptation();
+        WavOutp.OpenMonoWriteFile(SIM.OutFileName, BASEBAND_SAMPLE_RATE, 24, N);
 
-        SYS_HEAR_ApplySubbandGain();
+    // Do simulation, going through all blocks
 
-        FBC_DoFreqShift();
+        for (CurBlock = 0; CurBlock < BlocksInSim; CurBlock++)
+        {
+            TOP_ReadInput(8, Buf);          // SIM ONLY
 
-        SYS_HEAR_WolaFwdSynthesis();
+            TOP_ProcessBlock(Buf);
 
-        SYS_FENG_AgcO();
+            if (CurBlock > 5000)
+                CurBlock = CurBlock;
 
-//++++++++++++++++++++
-// Simulation
-        if (CurBlock > 5000)
-            CurBlock = CurBlock;
+            WavOutp.WriteNVals(8, Buf);      // SIM ONLY
+        }
+
+        SIM_CloseSim();
+    }
+    else
+    {
+    // One instance per channel, each on its own thread. Result files are prefixed by channel;
+    // the output .wav file has the same number of channels as the input
+
+        SIM_SetOutFileName();
+        WavOutp.OpenWriteFile(SIM.OutFileName, BASEBAND_SAMPLE_RATE, 24, N, (uint16_t)NumChannels);
+
+        MCH_Start(TOP_InitInstance, TOP_ProcessBlock);
+
+        for (CurBlock = 0; CurBlock < BlocksInSim; CurBlock += ChunkBlocks)
+        {
+            ChunkBlocks = BlocksInSim - CurBlock;
+            ChunkBlocks = (ChunkBlocks > MCH_CHUNK_BLOCKS) ? MCH_CHUNK_BLOCKS : ChunkBlocks;
 
-        for (k = 0; k < BLOCK_SIZE; k++)
-            Buf[k] = (int32_t)(round(SYS.OutBuf[k]/Scale24));       // This needs to be replaced with sending data to audio I/O block
-        WavOutp.WriteNVals(8, Buf);      // SIM ONLY
+            TOP_ReadInput((uint16_t)(ChunkBlocks*BLOCK_SIZE*NumChannels), MCH.IoBuf);      // SIM ONLY
+            MCH_RunChunk(ChunkBlocks);
+            WavOutp.WriteNVals((uint16_t)(ChunkBlocks*BLOCK_SIZE*NumChannels), MCH.IoBuf);   // SIM ONLY
+        }
 
-        SIM_LogFiles();
+        MCH_Stop();
     }
 
 //++++++++++++++++++++
 // Simulation
 
 // Close all files
-    WavInp.CloseFile();
+    TOP_CloseInput();
     WavOutp.CloseFile();
-    SIM_CloseSim();
 
 // Exit the program
     exit(0);
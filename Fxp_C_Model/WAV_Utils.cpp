@@ -37,6 +37,7 @@ int8_t RetVal = WavReadNoError;
 
             // dataSubchunk2Size = NumSamples * NumChannels * BytesPerSample
             NumSamples = (WavHeader.dataSubchunk2Size / BytesPerSample) / WavHeader.NumChannels;
+            NumVals = NumSamples * WavHeader.NumChannels;
             SamplesAccessed = 0;        // Reset how many samples have been read
             FileAccessType = 1;         // Mark as read file
         }
@@ -52,13 +53,14 @@ int8_t RetVal = WavReadNoError;
 
 // Read BufSamples into ValBuf. Use 32b containers pointed to by ValBuf to store values even if samples are smaller 
 // Also keeps track of how many overall samples have been read from this file and limits to sample size
+// Multi-channel files are read interleaved; BufSamples counts values, not frames
 // Returns actual number read
 uint16_t cWAVops::ReadNVals(uint16_t BufSamples, int32_t* ValBuf)
 {
 uint16_t i;
 int32_t Temp;
 
-    for (i = 0; (i < BufSamples) && (SamplesAccessed < NumSamples); i++, SamplesAccessed++)
+    for (i = 0; (i < BufSamples) && (SamplesAccessed < NumVals); i++, SamplesAccessed++)
     {
         fread(&Temp, 1, BytesPerSample, Fp);
         Temp = Temp << SignExtShift;       // shift to top
@@ -69,6 +71,13 @@ int32_t Temp;
 
 
 int8_t cWAVops::OpenMonoWriteFile(char* const OutFileName, uint16_t SampleRate, uint16_t BitsPerSample, uint32_t N)
+{
+    return OpenWriteFile(OutFileName, SampleRate, BitsPerSample, N, 1);
+}
+
+
+// N is samples per channel; values are written interleaved by WriteNVals()
+int8_t cWAVops::OpenWriteFile(char* const OutFileName, uint16_t SampleRate, uint16_t BitsPerSample, uint32_t N, uint16_t NumChannels)
 {
 int8_t RetVal = WavReadNoError;
 uint32_t DataSize;
@@ -80,6 +89,7 @@ uint32_t DataSize;
         {
         // Set up the header & class members
             NumSamples = N;
+            NumVals = N * NumChannels;
             BytesPerSample = BitsPerSample >> 3;    // Divide bits by 8 to get bytes
             SignExtShift = 32 - (BytesPerSample<<3);    // sign extension shift bits for 32b container
             SamplesAccessed = 0;        // reset # of samples written
@@ -89,7 +99,7 @@ uint32_t DataSize;
             WavHeader.RIFFChunkID[1] = 'I';
             WavHeader.RIFFChunkID[2] = 'F';
             WavHeader.RIFFChunkID[3] = 'F';
-            DataSize = NumSamples * (BitsPerSample >> 3);
+            DataSize = NumVals * (BitsPerSample >> 3);
             WavHeader.ChunkSize = 36 + DataSize;
             WavHeader.WAVEFormat[0] = 'W';
             WavHeader.WAVEFormat[1] = 'A';
@@ -101,16 +111,16 @@ uint32_t DataSize;
             WavHeader.fmtSubchunk1ID[3] = ' ';
             WavHeader.fmtSubchunk1Size = 16;    // default
             WavHeader.AudioFormat = 1;          // for PCM
-            WavHeader.NumChannels = 1;          // mono
+            WavHeader.NumChannels = NumChannels;
             WavHeader.SampleRate = SampleRate;
-            WavHeader.ByteRate = SampleRate * BytesPerSample;   // Assumes mono (SampleRate * NumChannels * BitsPerSample / 8)
-            WavHeader.BlockAlign = BytesPerSample;              // Again, assumes mono (NumChannels * BitsPerSample / 8)
+            WavHeader.ByteRate = SampleRate * NumChannels * BytesPerSample;     // (SampleRate * NumChannels * BitsPerSample / 8)
+            WavHeader.BlockAlign = NumChannels * BytesPerSample;                // (NumChannels * BitsPerSample / 8)
             WavHeader.BitsPerSample = BitsPerSample;
             WavHeader.dataSubchunk2ID[0] = 'd';
             WavHeader.dataSubchunk2ID[1] = 'a';
             WavHeader.dataSubchunk2ID[2] = 't';
             WavHeader.dataSubchunk2ID[3] = 'a';
-            WavHeader.dataSubchunk2Size = NumSamples * BytesPerSample;      // Again, mono (NumSamples * NumChannels * BitsPerSample / 8)
+            WavHeader.dataSubchunk2Size = NumVals * BytesPerSample;         // (NumSamples * NumChannels * BitsPerSample / 8)
         // Write the header to start the file
             fwrite(&WavHeader, 1, sizeof(WavHeader), Fp);
         }
@@ -126,12 +136,13 @@ uint32_t DataSize;
 
 // write BufSamples of samples coming from ValBuf. Use 32b containers pointed to by ValBuf to hold values even if samples are smaller
 // Also keeps track of overall number of samples written and stops when we hit specified number of samples (specified when file was opened)
+// Multi-channel files are written interleaved; BufSamples counts values, not frames
 // Returns actual number written
 uint16_t cWAVops::WriteNVals(uint16_t BufSamples, int32_t* ValBuf)
 {
 uint16_t i;
 
-    for (i = 0; (i < BufSamples) && (SamplesAccessed < NumSamples); i++, SamplesAccessed++)
+    for (i = 0; (i < BufSamples) && (SamplesAccessed < NumVals); i++, SamplesAccessed++)
     {
         fwrite(&ValBuf[i], 1, BytesPerSample, Fp);
     }
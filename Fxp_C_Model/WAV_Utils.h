@@ -48,8 +48,9 @@ private:
     strWAVFileHeader    WavHeader;
     FILE*               Fp;
     uint8_t             FileAccessType;     // 0 = not open yet, 1 = read, 2 = write
-    uint32_t            NumSamples;
-    uint32_t            SamplesAccessed;    // Samples already read or written
+    uint32_t            NumSamples;         // Samples per channel
+    uint32_t            NumVals;            // Total values in data chunk (NumSamples * channels); interleaved for multi-channel
+    uint32_t            SamplesAccessed;    // Values already read or written
     uint16_t            BytesPerSample;
     uint16_t            SignExtShift;       // Bits to shift up then down to sign extend into 32b container
 
@@ -68,6 +69,7 @@ public:
         Fp = NULL;
         FileAccessType = 0;
         NumSamples = 0;
+        NumVals = 0;
         SamplesAccessed = 0;
         BytesPerSample = 0;
         SignExtShift = 0;
@@ -83,9 +85,11 @@ public:
     inline uint16_t GetBitsPerSample() { return WavHeader.BitsPerSample; }
     inline uint32_t GetSampleRate() { return  WavHeader.SampleRate; }
     inline bool IsMono() { bool Ret = (WavHeader.NumChannels == 1); return Ret; }
+    inline uint16_t GetNumChannels() { return WavHeader.NumChannels; }
 
     uint16_t WriteNVals(uint16_t NumVals, int32_t* ValBuf);       // write NumVals of samples coming from ValBuf;
     int8_t OpenMonoWriteFile(char* const OutFileName, uint16_t SampleRate, uint16_t BitsPerSample, uint32_t NumSamples);
+    int8_t OpenWriteFile(char* const OutFileName, uint16_t SampleRate, uint16_t BitsPerSample, uint32_t NumSamples, uint16_t NumChannels);
     uint16_t ReadNVals(uint16_t NumVals, int32_t* ValBuf);        // Returns number of samples actually read
 
     inline void CloseFile() 
@@ -14,9 +14,53 @@
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 // Initialization at boot or profile switch
 
+// Build the channel to bin tables from the channel sizes. Sizes must be at least one bin and total
+// WOLA_NUM_BINS; returns false, leaving the tables as they were, if not.
+static bool WDRC_SetChannelMap(const int24_t* Sizes)
+{
+int24_t Start;
+int24_t c, bin;
+
+    Start = 0;
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+    {
+        if ((Sizes[c] < 1) || (Sizes[c] > (WOLA_NUM_BINS - Start)))
+            return false;
+        Start += Sizes[c];
+    }
+    if (Start != WOLA_NUM_BINS)
+        return false;
+
+    Start = 0;
+    for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+    {
+        WDRC.ChannelStartBin[c] = Start;
+        WDRC.ChannelLastBin[c] = Start + Sizes[c] - 1;
+        for (bin = WDRC.ChannelStartBin[c]; bin <= WDRC.ChannelLastBin[c]; bin++)
+            WDRC.BinChannel[bin] = c;
+        Start += Sizes[c];
+    }
+    return true;
+}
+
+
 void WDRC_Init()
 {
-uint8_t i;
+static const int24_t DefaultSize[WDRC_NUM_CHANNELS] = { WDRC_SIZE_CHAN_0, WDRC_SIZE_CHAN_1, WDRC_SIZE_CHAN_2, WDRC_SIZE_CHAN_3,
+                                                        WDRC_SIZE_CHAN_4, WDRC_SIZE_CHAN_5, WDRC_SIZE_CHAN_6, WDRC_SIZE_CHAN_7 };
+bool SizeSet;
+uint8_t i, j, k;
+
+// Channel map is needed even with WDRC off; FBC_Init() spreads the target gain by channel. All sizes zero
+// (not set) selects the default split.
+    SizeSet = false;
+    for (i = 0; i < WDRC_NUM_CHANNELS; i++)
+        SizeSet = SizeSet || (WDRC_Params.Persist.ChanSize[i] != 0);
+    WDRC.ChanMapRejected = SizeSet && !WDRC_SetChannelMap(WDRC_Params.Persist.ChanSize);
+    if (!SizeSet || WDRC.ChanMapRejected)
+        WDRC_SetChannelMap(DefaultSize);
+    if (WDRC.ChanMapRejected)
+        printf("\nWARNING: WDRC ChanSize must be 1 or more bins per channel, %d bins in total; using the default channel split\n\n", WOLA_NUM_BINS);
 
     if (WDRC_Params.Profile.Enable)
     {
@@ -45,125 +89,168 @@ uint8_t i;
 
         // Now finish Gain4 calc, knowing that Slope4 = -1
             WDRC.Gain[i][4] = (WDRC.Thresh[i][3] - WDRC.Thresh[i][4]) + WDRC.Gain[i][3];  // WDRC.Slope[4]*(WDRC.Thresh[4] - WDRC.Thresh[3]) + WDRC.Gain[3];
+
+        // Above full scale: unity gain, as when no region is found
+            WDRC.Gain[i][5] = to_frac16(0);
+            WDRC.Thresh[i][5] = WDRC.Thresh[i][4];
+            WDRC.Slope[i][5] = to_frac16(0);
         }
 
+    // Time constant table; see the selection in WDRC_Main()
+        WDRC.TC[WDRC_TC_EXPANS][0][0] = WDRC_Params.Persist.ExpansRelTC;
+        WDRC.TC[WDRC_TC_EXPANS][0][1] = WDRC_Params.Persist.ExpansSupraRelTC;
+        WDRC.TC[WDRC_TC_EXPANS][1][0] = WDRC_Params.Persist.ExpansAtkTC;
+        WDRC.TC[WDRC_TC_EXPANS][1][1] = WDRC_Params.Persist.ExpansSupraAtkTC;
+        WDRC.TC[WDRC_TC_COMPRESS][0][0] = WDRC_Params.Persist.CompressRelTC;
+        WDRC.TC[WDRC_TC_COMPRESS][0][1] = WDRC_Params.Persist.CompressSupraRelTC;
+        WDRC.TC[WDRC_TC_COMPRESS][1][0] = WDRC_Params.Persist.CompressAtkTC;
+        WDRC.TC[WDRC_TC_COMPRESS][1][1] = WDRC_Params.Persist.CompressSupraAtkTC;
+        WDRC.TC[WDRC_TC_LIMIT][0][0] = WDRC_Params.Persist.LimitRelTC;
+        WDRC.TC[WDRC_TC_LIMIT][0][1] = WDRC_Params.Persist.LimitSupraRelTC;
+        WDRC.TC[WDRC_TC_LIMIT][1][0] = WDRC_Params.Persist.LimitAtkTC;
+        WDRC.TC[WDRC_TC_LIMIT][1][1] = WDRC_Params.Persist.LimitSupraAtkTC;
+
+        WDRC.SupraThresh[WDRC_TC_EXPANS] = WDRC_Params.Profile.ExpansDiffThresh;
+        WDRC.SupraThresh[WDRC_TC_COMPRESS] = WDRC_Params.Profile.CompressDiffThresh;
+        WDRC.SupraThresh[WDRC_TC_LIMIT] = WDRC_Params.Profile.LimitDiffThresh;
+
+    // Channel update scheduling. The TC parameters are converted for one update of each channel every
+    // WDRC_NUM_CHANNELS blocks; when all channels update every UpdateDecim blocks instead, rescale them
+    // so the time constants in ms are unchanged (see rescale_TC())
+        WDRC.UpdateMode = (WDRC_Params.Persist.UpdateMode == WDRC_UPDATE_ALL) ? WDRC_UPDATE_ALL : WDRC_UPDATE_ROUND_ROBIN;
+        WDRC.UpdateDecim = maxint(minint(WDRC_Params.Persist.UpdateDecim, WDRC_MAX_UPDATE_DECIM), 1);
+        WDRC.DecimCount = 1;
+        if (WDRC.UpdateMode == WDRC_UPDATE_ALL)
+        {
+            for (i = 0; i < WDRC_NUM_TC_REGIONS; i++)
+                for (j = 0; j < 2; j++)
+                    for (k = 0; k < 2; k++)
+                        WDRC.TC[i][j][k] = rescale_TC(WDRC.TC[i][j][k], (double)WDRC.UpdateDecim/(double)WDRC_NUM_CHANNELS);
+        }
     }
 }
 
 
 //++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-// Main processing function
+// Channel update
 
-void WDRC_Main()
+// Level tracking and gain calculation for channels First..Last, given their linear energies; the caller
+// distributes WDRC.ChanGainLog2[] to the bins. Each step is
+// a separate pass over the channels, with table lookups in place of branches, so the passes vectorize
+// when all channels update together.
+static void WDRC_UpdateChannels(int24_t First, int24_t Last, const accum_t* ChanEnergy)
 {
-accum_t Acc;
-int24_t CurCh;
-frac16_t ChanEnergyLog2;
-frac16_t LevelDiff;
-frac24_t TC;
+frac16_t LevelDiff[WDRC_NUM_CHANNELS];
+frac24_t TC[WDRC_NUM_CHANNELS];
+int24_t Region[WDRC_NUM_CHANNELS];
 frac24_t Diff0, Diff3;
 frac16_t DiffThr;
-frac16_t Slope;
-frac16_t Gain;
-frac16_t ChanGainLog2;
-int24_t i;
+int24_t TcRegion, Attack, Supra;
+int24_t c, i;
 
-    if (WDRC_Params.Profile.Enable)
+    for (c = First; c <= Last; c++)
+    {
+        WDRC.ChanEnergyLog2[c] = shr(log2_approx(ChanEnergy[c]),1);       // Divide log2 by 2 to account for squared values
+        LevelDiff[c] = WDRC.ChanEnergyLog2[c] - WDRC.LevelLog2[c];
+    }
+
+    // Select the TC from the region of the input (expansion below Thresh0, limiting at or above Thresh3,
+    // else compression), attack or release, and whether the level change is past the region's supra
+    // threshold. Flags index WDRC.TC[][][] directly; thresholds must be ascending, as for the slopes.
+    for (c = First; c <= Last; c++)
+    {
+        Diff0 = WDRC.ChanEnergyLog2[c] - WDRC.Thresh[c][0];
+        Diff3 = WDRC.ChanEnergyLog2[c] - WDRC.Thresh[c][3];
+        TcRegion = (int24_t)(Diff0 >= 0) + (int24_t)(Diff3 >= 0);
+        Attack = (int24_t)(LevelDiff[c] > 0);
+        Supra = (int24_t)(abs_f24(LevelDiff[c]) > WDRC.SupraThresh[TcRegion]);
+        TC[c] = WDRC.TC[TcRegion][Attack][Supra];
+    }
+
+    // s1i7f16*s1i7f16 --> s1i14f33; shift left 7b to get f40, then HW rnd takes off 24b, back to f16
+    for (c = First; c <= Last; c++)
+        WDRC.LevelLog2[c] = mul_rnd16(TC[c], LevelDiff[c]) + WDRC.LevelLog2[c];     // Single-pole smoothing filter to update level
+
+    // Region is the number of thresholds the level is above; the first region whose threshold the level
+    // does not exceed, or WDRC_NUM_TABLE_REGIONS-1 (unity gain) if above them all
+    for (c = First; c <= Last; c++)
     {
-        CurCh = WDRC.CurrentChannel;
+        Region[c] = 0;
+        for (i = 0; i < NUM_WDRC_REGIONS; i++)
+            Region[c] += (int24_t)(WDRC.LevelLog2[c] > WDRC.Thresh[c][i]);
+    }
 
-        Acc = 0;
-        for (i = WDRC.ChannelStartBin[CurCh]; i <= WDRC.ChannelLastBin[CurCh]; i++)
-            Acc += (accum_t)SYS.BinEnergy[i];       // Add in linear domain; values are squared
+    // Calculate the gain for each channel
+    for (c = First; c <= Last; c++)
+    {
+        DiffThr = WDRC.LevelLog2[c] - WDRC.Thresh[c][Region[c]];
+        WDRC.ChanGainLog2[c] = mul_rnd16(WDRC.Slope[c][Region[c]], DiffThr) + WDRC.Gain[c][Region[c]];
+    }
+}
 
-        ChanEnergyLog2 = shr(log2_approx(Acc),1);       // Divide log2 by 2 to account for squared values
 
-        LevelDiff = ChanEnergyLog2 - WDRC.LevelLog2[CurCh];
-        Diff0 = ChanEnergyLog2 - WDRC.Thresh[CurCh][0];
-        Diff3 = ChanEnergyLog2 - WDRC.Thresh[CurCh][3];
-        WDRC.ChanEnergyLog2[CurCh] = ChanEnergyLog2;        // Save for debug
-        if (LevelDiff > 0)      // Input level is greater than current level --> attacking
+//++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+// Main processing function
+
+void WDRC_Main()
+{
+accum_t Acc;
+accum_t ChanEnergy[WDRC_NUM_CHANNELS];
+accum_t EnergyPrefix[WOLA_NUM_BINS+1];
+int24_t CurCh;
+int24_t c, i;
+
+    if (WDRC_Params.Profile.Enable)
+    {
+        if (WDRC.UpdateMode == WDRC_UPDATE_ALL)
         {
-            if (Diff0 < 0)          // input below Thresh0, in expansion region  BE - T0 < 0 ==> BE < T0
-            {
-                if (LevelDiff > WDRC_Params.Profile.ExpansDiffThresh)
-                    TC = WDRC_Params.Persist.ExpansSupraAtkTC;
-                else
-                    TC = WDRC_Params.Persist.ExpansAtkTC;
-            }
-            else if (Diff3 >= 0)    // input above Thresh3, in limiting region  BE - T3 >= 0 ==> BE >= T3
-            {
-                if (LevelDiff > WDRC_Params.Profile.LimitDiffThresh)
-                    TC = WDRC_Params.Persist.LimitSupraAtkTC;
-                else
-                    TC = WDRC_Params.Persist.LimitAtkTC;
-            }
-            else                    // input between T0 and T3 - compress region
+        // Gains hold between updates
+            WDRC.DecimCount--;
+            if (WDRC.DecimCount > 0)
+                return;
+            WDRC.DecimCount = WDRC.UpdateDecim;
+
+        // Prefix sum over the bins, in linear domain; each channel energy is then a single subtract
+            Acc = 0;
+            EnergyPrefix[0] = 0;
+            for (i = 0; i < WOLA_NUM_BINS; i++)
             {
-                if (LevelDiff > WDRC_Params.Profile.CompressDiffThresh)
-                    TC = WDRC_Params.Persist.CompressSupraAtkTC;
-                else
-                    TC = WDRC_Params.Persist.CompressAtkTC;
+                Acc += (accum_t)SYS.BinEnergy[i];
+                EnergyPrefix[i+1] = Acc;
             }
+            for (c = 0; c < WDRC_NUM_CHANNELS; c++)
+                ChanEnergy[c] = EnergyPrefix[WDRC.ChannelLastBin[c]+1] - EnergyPrefix[WDRC.ChannelStartBin[c]];
+
+            WDRC_UpdateChannels(0, WDRC_NUM_CHANNELS-1, ChanEnergy);
+
+        // Keep gain in log2; to combine gains across all algos, we'll add in log2, then do a single exp2 calc
+            for (i = 0; i < WOLA_NUM_BINS; i++)
+                WDRC.BinGainLog2[i] = WDRC.ChanGainLog2[WDRC.BinChannel[i]];
         }
-        else    // Input level below current level --> release
+        else
         {
-            if (Diff0 < 0)      // Expansion region
-            {
-                if (-LevelDiff > WDRC_Params.Profile.ExpansDiffThresh)    // Notice negation; if diff is large, use 'supra' TCs
-                    TC = WDRC_Params.Persist.ExpansSupraRelTC;
-                else
-                    TC = WDRC_Params.Persist.ExpansRelTC;
-            }
-            else if (Diff3 >= 0)    // Limiting region
-            {
-                if (-LevelDiff > WDRC_Params.Profile.LimitDiffThresh)
-                    TC = WDRC_Params.Persist.LimitSupraRelTC;
-                else
-                    TC = WDRC_Params.Persist.LimitRelTC;
-            }
-            else            // Compress region
-            {
-                if (-LevelDiff > WDRC_Params.Profile.CompressDiffThresh)
-                    TC = WDRC_Params.Persist.CompressSupraRelTC;
-                else
-                    TC = WDRC_Params.Persist.CompressRelTC;
-            }
-        }
+            CurCh = WDRC.CurrentChannel;
 
-    // s1i7f16*s1i7f16 --> s1i14f33; shift left 7b to get f40, then HW rnd takes off 24b, back to f16
-        WDRC.LevelLog2[CurCh] = mul_rnd16(TC, LevelDiff) + WDRC.LevelLog2[CurCh];     // Single-pole smoothing filter to update level
+            Acc = 0;
+            for (i = WDRC.ChannelStartBin[CurCh]; i <= WDRC.ChannelLastBin[CurCh]; i++)
+                Acc += (accum_t)SYS.BinEnergy[i];       // Add in linear domain; values are squared
+            ChanEnergy[CurCh] = Acc;
 
-    // Loop through regions until we find where level is below the region's threshold
-        Slope = to_frac16(0);
-        Gain = to_frac16(0);
-        for (i = 0; i <= 4; i++)
-        {
-            DiffThr = WDRC.LevelLog2[CurCh] - WDRC.Thresh[CurCh][i];
-            if (DiffThr <= 0)
+            WDRC_UpdateChannels(CurCh, CurCh, ChanEnergy);
+            for (i = WDRC.ChannelStartBin[CurCh]; i <= WDRC.ChannelLastBin[CurCh]; i++)
+                WDRC.BinGainLog2[i] = WDRC.ChanGainLog2[CurCh];     // Keep gain in log2; to combine gains across all algos, we'll add in log2, then do a single exp2 calc
+
+        // Go to next bin or wrap around
+            WDRC.CurrentChannel = CurCh+1;
+            if (WDRC.CurrentChannel >= WDRC_NUM_CHANNELS)
             {
-                Slope = WDRC.Slope[CurCh][i];
-                Gain = WDRC.Gain[CurCh][i];
-                break;      // get out of 'for' loop
+                WDRC.CurrentChannel = 0;
             }
         }
-
-    // Calculate the gain for this channel; distribute across bins
-        ChanGainLog2 = mul_rnd16(Slope, DiffThr) + Gain;
-        for (i = WDRC.ChannelStartBin[CurCh]; i <= WDRC.ChannelLastBin[CurCh]; i++)
-            WDRC.BinGainLog2[i] = ChanGainLog2;         // Keep gain in log2; to combine gains across all algos, we'll add in log2, then do a single exp2 calc
-        WDRC.ChanGainLog2[CurCh] = ChanGainLog2;        // Keep track for debugging
-
-    // Go to next bin or wrap around
-        WDRC.CurrentChannel = CurCh+1;
-        if (WDRC.CurrentChannel >= WDRC_NUM_CHANNELS)
-        {
-            WDRC.CurrentChannel = 0;
-        }
     }
     else    // If WDRC not enabled, use unity gain
     {
         for (i = 0; i < WOLA_NUM_BINS; i++)
             WDRC.BinGainLog2[i] = to_frac16(0.0);
     }
-}
\ No newline at end of file
+}
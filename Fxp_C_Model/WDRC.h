@@ -17,7 +17,20 @@
 
 // Set up these values at build time
 #define     NUM_WDRC_REGIONS        5       // 5 regions of WDRC action: expansion, lower compress, middle compress, upper compress, limiting
+#define     WDRC_NUM_TABLE_REGIONS  (NUM_WDRC_REGIONS + 1)      // Plus level above the top threshold: unity gain, zero slope
 
+// Time constant selection table, WDRC.TC[region][attack][supra]
+#define     WDRC_TC_EXPANS          0       // Channel energy below Thresh0
+#define     WDRC_TC_COMPRESS        1       // Between Thresh0 and Thresh3
+#define     WDRC_TC_LIMIT           2       // At or above Thresh3
+#define     WDRC_NUM_TC_REGIONS     3
+
+// Channel update scheduling (WDRC_Params.Persist.UpdateMode)
+#define     WDRC_UPDATE_ROUND_ROBIN 0       // One channel per block; each channel updates every WDRC_NUM_CHANNELS blocks
+#define     WDRC_UPDATE_ALL         1       // All channels together every UpdateDecim blocks
+#define     WDRC_MAX_UPDATE_DECIM   16
+
+// Default channel split, in bins; used when WDRC_Params.Persist.ChanSize is not set or is not valid
 #define     WDRC_SIZE_CHAN_0        1
 #define     WDRC_SIZE_CHAN_1        2
 #define     WDRC_SIZE_CHAN_2        2
@@ -44,20 +57,27 @@
 struct strWDRC
 {
     int24_t     CurrentChannel;
+    int24_t     UpdateMode;                             // WDRC_UPDATE_xxx
+    int24_t     UpdateDecim;                            // Blocks between updates, WDRC_UPDATE_ALL only
+    int24_t     DecimCount;                             // Blocks until the next update
     frac16_t    ChanEnergyLog2[WDRC_NUM_CHANNELS];      // Keep track for debug only
     frac16_t    LevelLog2[WDRC_NUM_CHANNELS];
     frac16_t    BinGainLog2[WOLA_NUM_BINS];
     frac16_t    ChanGainLog2[WDRC_NUM_CHANNELS];        // Keep track for debug only
-    // Bin boundaries are const, known at build time
-    const int24_t     ChannelStartBin[WDRC_NUM_CHANNELS];
-    const int24_t     ChannelLastBin[WDRC_NUM_CHANNELS];
-
-// WDRC working values
-    frac16_t    Gain[WDRC_NUM_CHANNELS][NUM_WDRC_REGIONS];
-    frac16_t    Thresh[WDRC_NUM_CHANNELS][NUM_WDRC_REGIONS];
-    frac16_t    Slope[WDRC_NUM_CHANNELS][NUM_WDRC_REGIONS];
-
-    // Constructor; used to initialize const values
+    // Channel to bin map; set from the parameters by WDRC_Init()
+    int24_t     ChannelStartBin[WDRC_NUM_CHANNELS];
+    int24_t     ChannelLastBin[WDRC_NUM_CHANNELS];
+    int24_t     BinChannel[WOLA_NUM_BINS];              // Channel of each bin
+    bool        ChanMapRejected;                        // ChanSize was set but not valid; default split in use
+
+// WDRC working values; per-channel gain curve tables indexed by region (count of thresholds below the level)
+    frac16_t    Gain[WDRC_NUM_CHANNELS][WDRC_NUM_TABLE_REGIONS];
+    frac16_t    Thresh[WDRC_NUM_CHANNELS][WDRC_NUM_TABLE_REGIONS];
+    frac16_t    Slope[WDRC_NUM_CHANNELS][WDRC_NUM_TABLE_REGIONS];
+    frac24_t    TC[WDRC_NUM_TC_REGIONS][2][2];          // [WDRC_TC_xxx][1 = attack][1 = supra]
+    frac16_t    SupraThresh[WDRC_NUM_TC_REGIONS];       // Level change beyond which the supra TC is used
+
+    // Constructor; starts with the default channel split
     strWDRC() : ChannelStartBin{ WDRC_START_BIN_CHAN0, WDRC_START_BIN_CHAN1, WDRC_START_BIN_CHAN2, WDRC_START_BIN_CHAN3,
                                  WDRC_START_BIN_CHAN4, WDRC_START_BIN_CHAN5, WDRC_START_BIN_CHAN6, WDRC_START_BIN_CHAN7},
                 ChannelLastBin {(WDRC_START_BIN_CHAN1-1), (WDRC_START_BIN_CHAN2-1), (WDRC_START_BIN_CHAN3-1), (WDRC_START_BIN_CHAN4-1),
@@ -65,14 +85,22 @@ struct strWDRC
     {
     unsigned i, j;
 
+        for (i = 0; i < WDRC_NUM_CHANNELS; i++)
+            for (j = ChannelStartBin[i]; j <= (unsigned)ChannelLastBin[i]; j++)
+                BinChannel[j] = i;
+        ChanMapRejected = false;
+
         CurrentChannel = 0;     // Reset
+        UpdateMode = WDRC_UPDATE_ROUND_ROBIN;
+        UpdateDecim = WDRC_NUM_CHANNELS;
+        DecimCount = 1;
     // Set energies, levels to low values.  Reset gains to unity in log2 (0 --> 1.0 linear)
         for (i = 0; i < WDRC_NUM_CHANNELS; i++)
         {
             ChanEnergyLog2[i] = to_frac16(-24.0);
             LevelLog2[i] = to_frac16(-24.0);
             ChanGainLog2[i] = to_frac16(0);
-            for (j = 0; j < NUM_WDRC_REGIONS; j++)
+            for (j = 0; j < WDRC_NUM_TABLE_REGIONS; j++)
             {
                 Gain[i][j] = to_frac16(0);
                 Thresh[i][j] = to_frac16(0);
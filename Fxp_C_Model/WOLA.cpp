@@ -162,6 +162,22 @@ void WOLA_Init(strWOLA* sWOLA, int8_t StackingSel, const frac24_t* AnalysisWin,
 }
 
 
+// Track how many of the most recent input samples are zero, to know when the whole analysis buffer is clear
+static void WOLA_UpdateZeroRun(strWOLA* sWOLA, frac24_t* AnaIn)
+{
+int i;
+bool BlockIsZero = true;
+
+    for (i = 0; i < WOLA_R; i++)
+        BlockIsZero = BlockIsZero && (AnaIn[i] == 0.0);
+
+    if (!BlockIsZero)
+        sWOLA->AnaZeroRun = 0;
+    else if (sWOLA->AnaZeroRun < WOLA_LA)
+        sWOLA->AnaZeroRun += WOLA_R;
+}
+
+
 // Analysis: bring in WOLA_R samples (AnaIn), buffer inside the WOLA structure (hidden memory), perform WOLA
 // processing, produce WOLA_NUM_BINS complex samples out (AnaOut)
 
@@ -185,6 +201,8 @@ frac24_t Rsh, Ish;
     for (i = 0; i < WOLA_R; i++)
         sWOLA->AnaBuf[WOLA_LA-WOLA_R+i] = AnaIn[i]*sWOLA->AnaSign;      // Sign sequencing
 
+    WOLA_UpdateZeroRun(sWOLA, AnaIn);
+
     if (WOLA_STACKING == WOLA_STACKING_ODD)
     {
         if ((sWOLA->AnaBlockCnt & (WOLA_OS-1)) == 0)
@@ -326,3 +344,56 @@ frac24_t Rsh;
     sWOLA->SynBlockCnt++;
 
 }
+
+
+// Low-power analysis: shift AnaIn into the analysis buffer and advance the block counters exactly as
+// WOLA_Analyze() does, but skip windowing and the FFT and output zeros. Only gives the same output
+// as WOLA_Analyze() when WOLA_AnaSilentAfterZeroBlock() was true and AnaIn is all zero.
+
+void WOLA_AdvanceAnalysis(strWOLA* sWOLA, frac24_t* AnaIn, Complex24* AnaOut)
+{
+int i;
+
+    for (i = WOLA_R; i < WOLA_LA; i++)
+        sWOLA->AnaBuf[i-WOLA_R] = sWOLA->AnaBuf[i];
+    for (i = 0; i < WOLA_R; i++)
+        sWOLA->AnaBuf[WOLA_LA-WOLA_R+i] = AnaIn[i]*sWOLA->AnaSign;
+
+    WOLA_UpdateZeroRun(sWOLA, AnaIn);
+
+    if (WOLA_STACKING == WOLA_STACKING_ODD)
+    {
+        if ((sWOLA->AnaBlockCnt & (WOLA_OS-1)) == 0)
+            sWOLA->AnaSign = sWOLA->AnaSign * -1.0;
+    }
+    sWOLA->AnaBlockCnt++;
+
+    for (i = 0; i < WOLA_NUM_BINS; i++)
+        AnaOut[i].SetVal(to_frac24(0.0), to_frac24(0.0));
+}
+
+
+// Low-power synthesis for an all-zero subband input: the inverse FFT and window would only add zeros,
+// so just move the overlap-add buffer along and output its oldest samples. Same output and state as
+// WOLA_Synthesize() with all-zero SynIn.
+
+void WOLA_AdvanceSynthesis(strWOLA* sWOLA, frac24_t* SynOut)
+{
+int16_t i;
+
+    for (i = WOLA_R; i < WOLA_LS; i++)
+        sWOLA->SynOlaBuf[i-WOLA_R] = sWOLA->SynOlaBuf[i];
+    for (i = 0; i < WOLA_R; i++)
+        sWOLA->SynOlaBuf[WOLA_LS-WOLA_R+i] = 0;
+
+    for (i = 0; i < WOLA_R; i++)
+        SynOut[i] = sWOLA->SynOlaBuf[i]*sWOLA->SynSign;
+
+    if (WOLA_STACKING == WOLA_STACKING_ODD)
+    {
+        if ((sWOLA->SynBlockCnt & (WOLA_OS-1)) == (WOLA_OS-1))
+            sWOLA->SynSign = sWOLA->SynSign * -1.0;
+    }
+
+    sWOLA->SynBlockCnt++;
+}
@@ -30,6 +30,7 @@ struct strWOLA
     int8_t      Stacking;
     uint8_t     AnaBlockCnt;
     uint8_t     SynBlockCnt;
+    uint16_t    AnaZeroRun;     // Consecutive all-zero input samples; analysis history is all zero once >= WOLA_LA
     frac24_t    AnaSign;
     frac24_t    SynSign;
 
@@ -58,6 +59,7 @@ struct strWOLA
         Stacking = -1;      // Init with illegal value
         AnaBlockCnt = 0;
         SynBlockCnt = 0;
+        AnaZeroRun = WOLA_LA;   // Buffer starts out cleared
         if ((WOLA_N < WOLA_LA) && (WOLA_STACKING == WOLA_STACKING_ODD))
             AnaSign = -1.0;
         else
@@ -73,6 +75,15 @@ struct strWOLA
 void WOLA_Init(strWOLA* sWOLA, int8_t StackingSel, const frac24_t* AnalysisWin, const frac24_t* SynthesisWin);
 void WOLA_Analyze(strWOLA* sWOLA, frac24_t* AnaIn, Complex24* AnaOut);
 void WOLA_Synthesize(strWOLA* sWOLA, Complex24* SynIn, frac24_t* SynOut);
+void WOLA_AdvanceAnalysis(strWOLA* sWOLA, frac24_t* AnaIn, Complex24* AnaOut);
+void WOLA_AdvanceSynthesis(strWOLA* sWOLA, frac24_t* SynOut);
+
+// True if the analysis window will hold only zeros once an all-zero input block is shifted in;
+// WOLA_AdvanceAnalysis() then gives the same (zero) output as WOLA_Analyze()
+inline bool WOLA_AnaSilentAfterZeroBlock(strWOLA* sWOLA)
+{
+    return ((sWOLA->AnaZeroRun + WOLA_R) >= WOLA_LA);
+}
 
 extern const frac24_t AnalysisWin[];
 extern const frac24_t SynthesisWin[];
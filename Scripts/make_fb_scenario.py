@@ -0,0 +1,55 @@
+#+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+# Python script to make a feedback path scenario for the C code
+# model (-f): a bank of path impulse responses as .npy, and a
+# schedule of path changes
+#
+# Novidan, Inc. (c) 2023.  May not be used or copied with prior consent
+# Bryant Sorensen
+# Started 19Oct2026
+#+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+import os
+import sys
+import struct
+
+FB_SIM_TAPS = 128       # Taps per FIR of a FB sim file without a FIRLEN line; see SIM.h
+
+def read_fbsim_paths(fname):
+# FIR1 and FIR2 of a FB sim file; the transition time is not used
+    with open(fname, 'r') as f:
+        tokens = f.read().split()
+    taps = FB_SIM_TAPS
+    if tokens[0] == 'FIRLEN':
+        taps = int(tokens[1])
+        tokens = tokens[2:]
+    vals = [float(x) for x in tokens[1:1+2*taps]]
+    return [vals[:taps], vals[taps:]]
+
+def write_bank(fname, paths):
+# .npy of doubles, shape (paths, taps), as numpy.save writes it; shorter paths are zero padded
+    taps = max(len(p) for p in paths)
+    hdr = "{'descr': '<f8', 'fortran_order': False, 'shape': (%d, %d), }" % (len(paths), taps)
+    hdr = hdr + ' '*(63 - (10 + len(hdr)) % 64) + '\n'
+    with open(fname, 'wb') as f:
+        f.write(b'\x93NUMPY\x01\x00' + struct.pack('<H', len(hdr)) + hdr.encode('latin1'))
+        for p in paths:
+            f.write(struct.pack('<%dd' % taps, *(p + [0.0]*(taps - len(p)))))
+
+def make_fb_scenario(out_name, num_changes, interval_sec, fade_sec, fbsim_fnames):
+# Cycles through the bank paths: path 0 at the start, then a change every interval_sec
+    paths = []
+    for fname in fbsim_fnames:
+        paths = paths + read_fbsim_paths(fname)
+    bank_fname = out_name + '_bank.npy'
+    write_bank(bank_fname, paths)
+    with open(out_name + '.txt', 'w') as f:
+        f.write('SCENARIO ' + os.path.basename(bank_fname) + '\n')
+        f.write('%.4f %d %.4f\n' % (0.0, 0, 0.0))
+        for k in range(1, num_changes+1):
+            f.write('%.4f %d %.4f\n' % (k*interval_sec, k % len(paths), fade_sec))
+
+if __name__ == '__main__':
+    if len(sys.argv) < 6:
+        print('Usage: make_fb_scenario.py <out name> <changes> <interval sec> <crossfade sec> <FB sim files...>')
+        sys.exit(1)
+    make_fb_scenario(sys.argv[1], int(sys.argv[2]), float(sys.argv[3]), float(sys.argv[4]), sys.argv[5:])
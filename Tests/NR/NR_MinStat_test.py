@@ -0,0 +1,242 @@
+#+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+# Python script comparing the NR noise floor estimators in the C code model:
+# slow rise / snap down (NoiseTracker 0) vs. minimum statistics (NoiseTracker 1)
+#
+# Novidan, Inc. (c) 2023.  May not be used or copied with prior consent
+# Bryant Sorensen
+# Started 19 Oct 2026
+#
+#+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+
+#+++++++++++++++++++
+# Test setup, here at top of file.  Everything needed to run this test, differentiating
+# if from other tests, should be included here.
+#
+# Test file names
+
+infile_name = 'NoiseSteps_Seg0p6sec_m96dB_to_m4dB_14p4sec.wav'
+speech_fname = 'OSR_us_000_0010_24k.wav'
+param_fname = 'NR_test.json'
+seg_sec = 0.6                   # Length of each noise level step in the input file
+
+# Speech in noise: silence, the speech file twice, silence; white noise throughout, stepping up halfway
+speech_pad_sec = 2.0
+speech_noise_db = (-50.0, -40.0)    # Noise level before / after the step, dBFS
+speech_skip_sec = 1.0           # Skipped after speech onset and after the noise step when measuring bias
+
+# Estimator settings to compare; everything else comes from param_fname
+trackers = [
+    ('SlowRise',    {'NoiseTracker': 0}),
+    ('MinStat300',  {'NoiseTracker': 1, 'MinStatWindow': 300.0, 'MinStatBias': 0.5}),
+    ('MinStat1000', {'NoiseTracker': 1, 'MinStatWindow': 1000.0, 'MinStatBias': 0.0}),
+]
+
+settle_tol_db = 3.0             # Recovery: time until the estimate stays within this of the segment reference
+
+#+++++++++++++++++++
+#Imports
+
+import sys
+import subprocess as subpr
+import os
+import json
+import wave
+import numpy as np
+
+#+++++++++++++++++++
+# Set up directories and common names
+
+repo_dir = os.getenv('FW_REPO_DIR')
+
+c_model_name = 'Fxp_C_Model'
+build_config = 'Release'    # Alternatives: Release, Debug
+build_platform = 'x64'      # Alternatives: Win32, x64
+
+thisdir = os.path.dirname(__file__)
+testfilename = os.path.basename(__file__)
+testname = os.path.splitext(testfilename)[0]
+
+param_defs_dir = os.path.join(repo_dir, 'ParamDefs')
+c_code_dir = os.path.join(repo_dir, c_model_name)
+scripts_dir = os.path.join(repo_dir, 'Scripts')
+test_dir = os.path.join(repo_dir, 'Tests')
+test_inputs_dir = os.path.join(test_dir, 'Input_Files')
+
+sys.path.append(scripts_dir)            # Add scripts to path dynamically
+import create_param_init_c_code as ic   # Import custom scripts
+
+if build_platform == 'Win32':
+    exe_subdir = build_config
+else:
+    exe_subdir = os.path.join('x64', build_config)
+exe_dir = os.path.join(c_code_dir, exe_subdir)
+exefile_name = os.path.join(exe_dir, c_model_name+'.exe')
+
+resultroot = os.path.join(thisdir, "Results", testname)
+if not os.path.exists(resultroot):
+    os.makedirs(resultroot)
+
+LOG2_TO_DB20 = 6.020599913279624
+SB_SAMPLE_RATE = 24000.0/8.0    # NR result files have one row per block
+
+#+++++++++++++++++++
+# Input: the rising steps as given, then the same segments in reverse order, so the falling steps start
+# from a settled estimate
+
+def make_rise_fall_input(src_path, dst_path):
+    src = wave.open(src_path, 'rb')
+    params = src.getparams()
+    seg_bytes = int(seg_sec*params.framerate)*params.sampwidth*params.nchannels
+    data = src.readframes(params.nframes)
+    src.close()
+    segs = [data[i:i+seg_bytes] for i in range(0, len(data), seg_bytes)]
+    dst = wave.open(dst_path, 'wb')
+    dst.setparams(params)
+    dst.writeframes(b''.join(segs + segs[::-1]))
+    dst.close()
+    return len(segs)
+
+infile_path = os.path.join(resultroot, 'RiseFall_' + infile_name)
+num_steps = make_rise_fall_input(os.path.join(test_inputs_dir, infile_name), infile_path)
+
+# Speech in noise, plus the same noise alone; the fast estimate of the noise alone is the reference
+
+def read_wav24(path):
+    src = wave.open(path, 'rb')
+    data = np.frombuffer(src.readframes(src.getnframes()), dtype=np.uint8).reshape(-1, 3)
+    src.close()
+    vals = data[:, 0].astype(np.int32) | (data[:, 1].astype(np.int32) << 8) | (data[:, 2].astype(np.int8).astype(np.int32) << 16)
+    return vals/8388608.0
+
+def write_wav24(path, x):
+    vals = np.clip(np.round(x*8388608.0), -8388608, 8388607).astype(np.int32)
+    dst = wave.open(path, 'wb')
+    dst.setnchannels(1)
+    dst.setsampwidth(3)
+    dst.setframerate(24000)
+    dst.writeframes(np.stack([vals & 0xFF, (vals >> 8) & 0xFF, (vals >> 16) & 0xFF], axis=1).astype(np.uint8).tobytes())
+    dst.close()
+
+def make_speech_inputs(speech_path, mix_path, noise_path):
+    speech = read_wav24(speech_path)
+    pad = np.zeros(int(speech_pad_sec*24000))
+    mix = np.concatenate((pad, speech, speech, pad))
+    step = len(pad) + len(speech)
+    level = np.where(np.arange(len(mix)) < step, speech_noise_db[0], speech_noise_db[1])
+    noise = np.random.default_rng(1).standard_normal(len(mix))*10.0**(level/20.0)
+    write_wav24(mix_path, mix + noise)
+    write_wav24(noise_path, noise)
+    return (speech_pad_sec, step/24000.0, (len(mix) - len(pad))/24000.0)
+
+mix_path = os.path.join(resultroot, 'SpeechNoise.wav')
+noise_path = os.path.join(resultroot, 'SpeechNoise_NoiseOnly.wav')
+speech_times = make_speech_inputs(os.path.join(test_inputs_dir, speech_fname), mix_path, noise_path)
+
+#+++++++++++++++++++
+# Build and run the model once per estimator
+
+def build_model(param_val_fname):
+    out_fname = os.path.join(c_code_dir, 'FW_Param_Init.cpp')
+    ic.create_param_init_c_code(param_val_fname, '1', param_defs_dir, out_fname)
+    os.chdir(c_code_dir)
+    c_build = "MSBuild.exe " + c_model_name + ".sln /p:Configuration=" + build_config + " /property:Platform=" + build_platform + " /verbosity:quiet"
+    rval = subpr.call(c_build, shell=True)
+    if (rval != 0):
+        print ('Error in build call!\n')
+        exit(rval)
+
+def run_model(infile_path, resultpath):
+    if not os.path.exists(resultpath):
+        os.makedirs(resultpath)
+    os.chdir(exe_dir)
+    c_exe_cmd = exefile_name + " -s " + infile_path + " -r " + resultpath + " -T NR_NoiseEst,NR_FastNoiseEst"
+    out = subpr.run(c_exe_cmd, shell=True, capture_output=True, text=True)
+    if (out.returncode != 0):
+        print ('Error in exe call!\n')
+        exit (out.returncode)
+    return out.stdout
+
+def read_trace(fname):
+    return np.load(fname).tolist()
+
+#+++++++++++++++++++
+# Scoring. The reference for each segment is the mean fast noise estimate over its second half, per bin.
+#   Bias: mean of (estimate - reference) over the second half of each segment, in dB
+#   Recovery: time after each level step until the estimate stays within settle_tol_db of the new reference
+
+def score(est, fast, first_seg, last_seg):
+    seg_rows = int(seg_sec*SB_SAMPLE_RATE)
+    num_bins = len(est[0])
+    bias = []
+    recovery = []
+    for s in range(first_seg, last_seg+1):
+        rows = range(s*seg_rows, (s+1)*seg_rows)
+        half = rows[seg_rows//2:]
+        for b in range(num_bins):
+            ref = sum(fast[r][b] for r in half)/len(half)
+            bias.append(sum(est[r][b] - ref for r in half)/len(half)*LOG2_TO_DB20)
+            last_out = -1
+            for k, r in enumerate(rows):
+                if abs(est[r][b] - ref)*LOG2_TO_DB20 > settle_tol_db:
+                    last_out = k
+            recovery.append((last_out + 1)/SB_SAMPLE_RATE*1000.0)
+    return (sum(bias)/len(bias), sum(abs(x) for x in bias)/len(bias), sum(recovery)/len(recovery), max(recovery))
+
+# Speech in noise, against the noise-only fast estimate at each block:
+#   Bias: mean of (estimate - reference) while speech is present, before and after the noise step, in dB
+#   Step: the same over the speech_skip_sec after the noise step; negative when the estimate lags the rise
+
+def score_speech(est, ref):
+    onset, step, end = [int(t*SB_SAMPLE_RATE) for t in speech_times]
+    skip = int(speech_skip_sec*SB_SAMPLE_RATE)
+    est = np.array(est)
+    ref = np.array(ref)
+    err = (est - ref)*LOG2_TO_DB20
+    bias_before = err[onset+skip:step].mean()
+    bias_after = err[step+skip:end].mean()
+    bias_step = err[step:step+skip].mean()
+    return (bias_before, bias_step, bias_after)
+
+#+++++++++++++++++++
+# Run all combinations and print the comparison
+
+with open(os.path.join(thisdir, param_fname), 'r') as f:
+    base_params = json.load(f)
+
+results = []
+for tname, settings in trackers:
+    params = json.loads(json.dumps(base_params))
+    params['NR']['0'].update(settings)
+    param_val_fname = os.path.join(resultroot, tname + '_' + param_fname)
+    with open(param_val_fname, 'w') as f:
+        json.dump(params, f, indent=1)
+    build_model(param_val_fname)
+
+    resultpath = os.path.join(resultroot, tname)
+    stdout = run_model(infile_path, resultpath)
+    cost = [line for line in stdout.splitlines() if line.startswith('NR minimum statistics')]
+    cost = cost[0] if cost else ''
+    est = read_trace(os.path.join(resultpath, 'NR_NoiseEst.npy'))
+    fast = read_trace(os.path.join(resultpath, 'NR_FastNoiseEst.npy'))
+    # Segment 0 is the initial acquisition; segment num_steps repeats the loudest level
+    rising = score(est, fast, 1, num_steps-1)
+    falling = score(est, fast, num_steps+1, 2*num_steps-1)
+
+    run_model(mix_path, resultpath + '_Speech')
+    run_model(noise_path, resultpath + '_NoiseOnly')
+    est = read_trace(os.path.join(resultpath + '_Speech', 'NR_NoiseEst.npy'))
+    ref = read_trace(os.path.join(resultpath + '_NoiseOnly', 'NR_FastNoiseEst.npy'))
+    results.append((tname, rising, falling, score_speech(est, ref), cost))
+
+print ('Noise steps')
+print ('%-12s %-8s %12s %12s %14s %14s  %s' % ('Estimator', 'Steps', 'MeanBiasDb', 'MeanAbsDb', 'MeanRecovMs', 'MaxRecovMs', 'Cost'))
+for tname, rising, falling, speech, cost in results:
+    print ('%-12s %-8s %12.2f %12.2f %14.1f %14.1f  %s' % ((tname, 'Rising') + rising + (cost,)))
+    print ('%-12s %-8s %12.2f %12.2f %14.1f %14.1f  %s' % ((tname, 'Falling') + falling + (cost,)))
+print ('\nSpeech in noise, %.0f dBFS noise stepping to %.0f dBFS' % speech_noise_db)
+print ('%-12s %14s %14s %14s' % ('Estimator', 'BiasBeforeDb', 'BiasStepDb', 'BiasAfterDb'))
+for tname, rising, falling, speech, cost in results:
+    print ('%-12s %14.2f %14.2f %14.2f' % ((tname,) + speech))
+
+#+++++++++++++++++++
+os.chdir(thisdir)